@@ -0,0 +1,265 @@
+// Firmware unificado da BitDogLab: os monitores de botões e de joystick e o semáforo
+// numa única imagem, como módulos (modulo.h) escolhidos no CMake (-DMOD_BOTOES,
+// -DMOD_JOYSTICK, -DMOD_SEMAFORO). Em vez de um laço bloqueante por aplicação, tudo
+// roda como tarefas run-to-completion no escalonador cooperativo (common/sched),
+// com um único motor de amostragem do ADC (common/sampling), um único servidor HTTP
+// (common/http/http_server.c) e um único caminho de telemetria (/history).
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/tcp.h"
+#include "lwip/netif.h"
+#include "modulo.h"
+#include "sched.h"
+#include "sampler.h"
+#include "http_server.h"
+#include "http_stream.h"
+#include "http_cache.h"
+#include "history.h"
+#include "trace_rec.h"
+#include "mem_stats.h"
+#include "deadline.h"
+#include "profiler.h"
+#include "hot_path.h"
+#include "isr_bench.h"
+
+// Configurações de Wi-Fi
+#define WIFI_SSID "nome"
+#define WIFI_PASSWORD "senha"
+
+#define SAMPLE_HZ 1000         // frequência base do motor de amostragem
+#define HISTORY_CAPACITY 1024  // registros de telemetria (~100 s a 10 Hz)
+
+static const modulo_t *const modulos[] = {
+#if MOD_BOTOES
+    &modulo_botoes,
+#endif
+#if MOD_JOYSTICK
+    &modulo_joystick,
+#endif
+#if MOD_SEMAFORO
+    &modulo_semaforo,
+#endif
+};
+#define NUM_MODULOS (sizeof(modulos) / sizeof(modulos[0]))
+
+HISTORY_DECLARE(telemetria, telemetria_t, HISTORY_CAPACITY);
+DEADLINE_PHASE(phase_wifi, "wifi_connect", 20500); // timeout do connect + folga
+
+static void registrar_telemetria(void);
+static void consultar_console(void);
+static void consultar_rede(void);
+static void relatorio(void);
+static size_t render_page(char *buf, size_t max);
+
+// Tarefas do próprio firmware; as dos módulos são registradas no 'iniciar' de cada um
+SCHED_TASK(tarefa_telemetria, "telemetria", registrar_telemetria, 100, 3, 5);
+SCHED_TASK(tarefa_rede, "rede", consultar_rede, 10, 1, 5);
+SCHED_TASK(tarefa_console, "console", consultar_console, 100, 6, 20);
+SCHED_TASK(tarefa_relatorio, "relatorio", relatorio, 10000, 7, 50);
+HTTP_CACHE_DECLARE(page_cache, "pagina", render_page);
+
+//------------- Um registro com os campos de todos os módulos a cada 100 ms
+static void registrar_telemetria(void)
+{
+    telemetria_t t = {.t_ms = to_ms_since_boot(get_absolute_time())};
+    for (size_t i = 0; i < NUM_MODULOS; i++)
+        modulos[i]->telemetria(&t);
+    history_push(&telemetria, &t);
+}
+
+// Um registro como linha CSV ou registro binário de 16 bytes (little-endian):
+// seq u32, t_ms u32, temp_centi i16, botões u8, x i8, y i8, direção u8, sw u8, fase u8
+static size_t format_history_sample(const void *amostra, uint32_t seq, bool binario, char *buf, size_t max)
+{
+    const telemetria_t *s = amostra;
+    if (binario) {
+        if (max < 16)
+            return 0;
+        memcpy(buf, &seq, 4);
+        memcpy(buf + 4, &s->t_ms, 4);
+        memcpy(buf + 8, &s->temp_centi, 2);
+        buf[10] = (char)s->botoes;
+        buf[11] = (char)s->x;
+        buf[12] = (char)s->y;
+        buf[13] = (char)s->direcao;
+        buf[14] = (char)s->sw;
+        buf[15] = (char)s->fase;
+        return 16;
+    }
+    char linha[64];
+    int t = s->temp_centi < 0 ? -s->temp_centi : s->temp_centi;
+    int n = snprintf(linha, sizeof(linha), "%lu,%lu,%s%d.%02d,%d,%d,%d,%d,%u,%u,%u\n",
+                     (unsigned long)seq, (unsigned long)s->t_ms, s->temp_centi < 0 ? "-" : "", t / 100, t % 100,
+                     s->botoes & 1, (s->botoes >> 1) & 1, s->x, s->y, s->direcao, s->sw, s->fase);
+    if (n < 0 || (size_t)n > max)
+        return 0;
+    memcpy(buf, linha, n);
+    return n;
+}
+
+// GET /history?since=<seq>&fmt=csv|bin: telemetria de todos os módulos, chunked
+static err_t serve_history(struct tcp_pcb *tpcb, const char *alvo)
+{
+    history_stream_t estado;
+    history_stream_init(&estado, &telemetria, format_history_sample,
+                        "seq,t_ms,temperatura,botao1,botao2,x,y,direcao,sw,fase\n", alvo);
+    TRACE_HTTP(estado.binario ? TRACE_HTTP_HISTORY_BIN : TRACE_HTTP_HISTORY_CSV, estado.seq);
+
+    char extra[40];
+    snprintf(extra, sizeof(extra), "X-History-Next: %lu\r\n", (unsigned long)estado.fim);
+    err_t e = http_stream_start(tpcb, estado.binario ? "application/octet-stream" : "text/csv", extra,
+                                history_stream_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
+
+// Página principal: cabeçalho comum e a seção de cada módulo; renderizada uma vez por
+// geração (a soma das gerações dos módulos, que só avançam)
+static size_t render_page(char *buf, size_t max)
+{
+    int n = snprintf(buf, max,
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html; charset=UTF-8\r\n"
+        "Connection: close\r\n\r\n"
+        "<!DOCTYPE html><html><head>"
+        "<meta charset=\"UTF-8\">"
+        "<title>BitDogLab</title>"
+        "<meta http-equiv='refresh' content='1'>"
+        "<style>"
+        "body {font-family: Arial; text-align: center;}"
+        ".s {padding: 10px; margin: 5px auto; width: 300px; border-radius: 10px; color: white;}"
+        ".on {background: #4CAF50;} .off {background: #f44336;}"
+        ".d {font-size: 24px; color: #e91e63; font-weight: bold;}"
+        "</style></head><body><h1>Monitor BitDogLab</h1>");
+    if (n < 0 || (size_t)n >= max)
+        return 0;
+    size_t total = (size_t)n;
+    for (size_t i = 0; i < NUM_MODULOS; i++) {
+        size_t s = modulos[i]->secao(buf + total, max - total);
+        if (s == 0)
+            return 0;
+        total += s;
+    }
+    static const char fim[] = "</body></html>";
+    if (total + sizeof(fim) > max)
+        return 0;
+    memcpy(buf + total, fim, sizeof(fim) - 1);
+    return total + sizeof(fim) - 1;
+}
+
+static uint32_t page_generation(void)
+{
+    uint32_t g = 0;
+    for (size_t i = 0; i < NUM_MODULOS; i++)
+        g += *modulos[i]->geracao;
+    return g;
+}
+
+static err_t serve_page(struct tcp_pcb *tpcb, const char *alvo)
+{
+    (void)alvo; // a página não tem parâmetros
+    TRACE_HTTP(TRACE_HTTP_ROOT, 0);
+    // Todos os clientes da mesma geração recebem o mesmo buffer
+    if (http_cache_send(&page_cache, tpcb, page_generation()) == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return ERR_OK;
+}
+
+#if PROFILER
+// GET /profile[?reset=1]: histograma de PCs no mesmo formato do dump pela UART
+static err_t serve_profile(struct tcp_pcb *tpcb, const char *alvo)
+{
+    char valor[4];
+    if (http_query_param(alvo, "reset", valor, sizeof(valor)) && strcmp(valor, "1") == 0)
+        profiler_reset();
+    profiler_stream_t estado;
+    profiler_stream_init(&estado);
+    err_t e = http_stream_start(tpcb, "text/plain", NULL, profiler_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
+HTTP_ROUTE(rota_profile, "/profile", serve_profile);
+#endif
+HTTP_ROUTE(rota_history, "/history", serve_history);
+HTTP_ROUTE(rota_page, "/", serve_page);
+
+static void consultar_rede(void)
+{
+    cyw43_arch_poll();
+}
+
+static void consultar_console(void)
+{
+    TRACE_POLL();
+    PROFILER_POLL();
+}
+
+//------------- Relatórios a cada 10 s: memória, prazos, cache da página e CPU por tarefa
+static void relatorio(void)
+{
+    MEM_STATS_REPORT();
+    DEADLINE_REPORT();
+    http_cache_report(&page_cache);
+    sampler_report();
+    sched_report();
+}
+
+//------------- Wi-Fi e servidor; sem rede os módulos locais seguem rodando
+static bool iniciar_rede(void)
+{
+    if (cyw43_arch_init()) {
+        printf("Erro na inicialização do Wi-Fi\n");
+        return false;
+    }
+    cyw43_arch_enable_sta_mode();
+
+    printf("Conectando a %s...\n", WIFI_SSID);
+    DEADLINE_BEGIN(phase_wifi);
+    int falha_wifi = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000);
+    DEADLINE_END(phase_wifi);
+    if (falha_wifi) {
+        printf("Falha na conexão Wi-Fi\n");
+        return false;
+    }
+    printf("Conectado! IP: %s\n", ip4addr_ntoa(netif_ip4_addr(netif_default)));
+
+#if PROFILER
+    http_server_route(&rota_profile);
+#endif
+    http_server_route(&rota_history);
+    http_server_route(&rota_page);
+    return http_server_start(80);
+}
+
+int main()
+{
+    MEM_STATS_INIT(); // Pinta as pilhas (modo STATIC_ALLOC)
+    stdio_init_all();
+    DEADLINE_INIT(); // Watchdog; imprime o travamento que causou o último reset
+    PROFILER_INIT(); // Amostragem do PC a ~1 kHz (modo PROFILER)
+    printf("Inicializando sistema...\n");
+
+    // Módulos: pinos, grupos de amostragem e tarefas
+    adc_init();
+    for (size_t i = 0; i < NUM_MODULOS; i++) {
+        printf("Módulo %s\n", modulos[i]->nome);
+        modulos[i]->iniciar();
+    }
+    sampler_start(SAMPLE_HZ);
+
+    if (iniciar_rede())
+        sched_add(&tarefa_rede, 0);
+    TRACE_INIT();
+    sched_add(&tarefa_telemetria, 0);
+    sched_add(&tarefa_console, 0);
+    sched_add(&tarefa_relatorio, 10000);
+
+    ISR_BENCH_RUN(); // latência de IRQ com tratador na flash e na SRAM (modo ISR_BENCH)
+    sched_run();
+}
@@ -0,0 +1,75 @@
+// Módulo de botões e temperatura (antigo botoes_webserver): botões A e B com debounce
+// e temperatura do sensor interno, lida pelo motor de amostragem a 10 Hz.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/sync.h"
+#include "bitdoglab.h"
+#include "modulo.h"
+#include "sched.h"
+#include "sampler.h"
+
+typedef struct {
+    bool button1_pressed;
+    bool button2_pressed;
+    float temperature;
+} botoes_estado_t;
+
+static botoes_estado_t estado;      // exibido na página (lido no callback do lwIP)
+static volatile uint32_t geracao;
+static bool last_button1_state, last_button2_state;
+static absolute_time_t last_button1_time, last_button2_time;
+
+static void atualizar(void);
+SAMPLER_GROUP(grupo_temperatura, "temperatura", 100, NULL, TEMPERATURA_ADC);
+SCHED_TASK(tarefa_botoes, "botoes", atualizar, 100, 2, 5);
+
+//------------- Tarefa de 100 ms: botões com debounce e última leitura da temperatura
+static void atualizar(void)
+{
+    if (grupo_temperatura.leituras == 0)
+        return; // ainda sem leitura do sensor
+    bool b1 = debounce_button(BOTAO_A_PIN, &last_button1_state, &last_button1_time);
+    bool b2 = debounce_button(BOTAO_B_PIN, &last_button2_state, &last_button2_time);
+    float temperature = bitdoglab_temperatura(grupo_temperatura.ultima[0]);
+    if (b1 == estado.button1_pressed && b2 == estado.button2_pressed && temperature == estado.temperature)
+        return;
+    uint32_t irq = save_and_disable_interrupts(); // a página é renderizada no callback do lwIP
+    estado.button1_pressed = b1;
+    estado.button2_pressed = b2;
+    estado.temperature = temperature;
+    geracao++;
+    restore_interrupts(irq);
+}
+
+static void iniciar(void)
+{
+    bitdoglab_botao_init(BOTAO_A_PIN);
+    bitdoglab_botao_init(BOTAO_B_PIN);
+    adc_set_temp_sensor_enabled(true);
+    sampler_add(&grupo_temperatura);
+    sched_add(&tarefa_botoes, 0);
+}
+
+static size_t secao(char *buf, size_t max)
+{
+    int n = snprintf(buf, max,
+                     "<h2>Botões</h2>"
+                     "<div class='s %s'>Botão 1: %s</div>"
+                     "<div class='s %s'>Botão 2: %s</div>"
+                     "<div>Temperatura: %.2f°C</div>",
+                     estado.button1_pressed ? "on" : "off", estado.button1_pressed ? "Ativo" : "Inativo",
+                     estado.button2_pressed ? "on" : "off", estado.button2_pressed ? "Ativo" : "Inativo",
+                     estado.temperature);
+    return n < 0 || (size_t)n >= max ? 0 : (size_t)n;
+}
+
+static void telemetria(telemetria_t *t)
+{
+    float c = estado.temperature * 100.0f;
+    t->temp_centi = (int16_t)(c < 0 ? c - 0.5f : c + 0.5f);
+    t->botoes = (estado.button1_pressed ? 1 : 0) | (estado.button2_pressed ? 2 : 0);
+}
+
+const modulo_t modulo_botoes = {"botoes", iniciar, secao, telemetria, &geracao};
@@ -0,0 +1,92 @@
+// Módulo do joystick (antigo joystck_wifi_webserver): os dois eixos entram no pipeline
+// de joystick_pipeline.c a 1 kHz, direto da interrupção do motor de amostragem; a
+// tarefa de 100 ms publica a leitura filtrada para a página e a telemetria.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/sync.h"
+#include "bitdoglab.h"
+#include "modulo.h"
+#include "sched.h"
+#include "sampler.h"
+#include "joystick_pipeline.h"
+#include "trace_rec.h"
+#include "hot_path.h"
+
+typedef struct {
+    int x_position; // -100 a 100, relativo ao centro calibrado
+    int y_position;
+    bool button_pressed;
+    direcao_t direction;
+} joystick_data_t;
+
+static joystick_pipeline_t joystick; // atualizado na interrupção do motor de amostragem
+static joystick_data_t page_data;    // leitura exibida na página, da tarefa
+static volatile uint32_t geracao;
+
+static void consumir(const uint16_t *leituras);
+static void publicar(void);
+SAMPLER_GROUP(grupo_joystick, "joystick", 1, consumir, JOYSTICK_X_ADC, JOYSTICK_Y_ADC);
+SCHED_TASK(tarefa_joystick, "joystick", publicar, 100, 2, 5);
+
+static void HOT_PATH(consumir)(const uint16_t *leituras)
+{
+    joystick_pipeline_update(&joystick, leituras[0], leituras[1]);
+}
+
+//------------- Tarefa de 100 ms: leitura filtrada e botão SW; só muda a geração se algo exibido mudou
+static void publicar(void)
+{
+    joystick_data_t data;
+    uint32_t irq = save_and_disable_interrupts();
+    data.x_position = joystick_percentual(joystick.nx);
+    data.y_position = joystick_percentual(joystick.ny);
+    data.direction = joystick.direcao;
+    restore_interrupts(irq);
+    bool nivel = gpio_get(JOYSTICK_SW_PIN);
+    TRACE_GPIO(JOYSTICK_SW_PIN, nivel);
+    data.button_pressed = !nivel; // LOW quando pressionado
+
+    if (data.x_position == page_data.x_position && data.y_position == page_data.y_position &&
+        data.direction == page_data.direction && data.button_pressed == page_data.button_pressed)
+        return;
+    irq = save_and_disable_interrupts(); // a renderização roda no callback do lwIP
+    page_data = data;
+    geracao++;
+    restore_interrupts(irq);
+}
+
+static void iniciar(void)
+{
+    bitdoglab_botao_init(JOYSTICK_SW_PIN);
+    adc_gpio_init(JOYSTICK_X_PIN);
+    adc_gpio_init(JOYSTICK_Y_PIN);
+    // As primeiras amostras calibram o centro com o joystick em repouso
+    joystick_pipeline_init(&joystick);
+    page_data.direction = DIR_CENTRO;
+    sampler_add(&grupo_joystick);
+    sched_add(&tarefa_joystick, 0);
+}
+
+static size_t secao(char *buf, size_t max)
+{
+    int n = snprintf(buf, max,
+                     "<h2>Joystick</h2>"
+                     "<div>posição X: %d &nbsp; posição Y: %d</div>"
+                     "<div class='d'>rosa dos ventos: %s</div>"
+                     "<div>Botão: %s</div>",
+                     page_data.x_position, page_data.y_position, joystick_direcao_nome(page_data.direction),
+                     page_data.button_pressed ? "Pressionado" : "Não pressionado");
+    return n < 0 || (size_t)n >= max ? 0 : (size_t)n;
+}
+
+static void telemetria(telemetria_t *t)
+{
+    t->x = (int8_t)page_data.x_position;
+    t->y = (int8_t)page_data.y_position;
+    t->direcao = (uint8_t)page_data.direction;
+    t->sw = page_data.button_pressed;
+}
+
+const modulo_t modulo_joystick = {"joystick", iniciar, secao, telemetria, &geracao};
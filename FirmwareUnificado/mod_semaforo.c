@@ -0,0 +1,201 @@
+// Módulo do semáforo (antigo SemaforoComBotão): o mesmo ciclo verde obrigatório ->
+// verde flexível -> amarelo -> vermelho com bips e sinal de pedestre na matriz, mas
+// como sequência de passos curtos. Cada passo liga ou desliga uma saída e diz quanto
+// esperar até o próximo; o escalonador marca a liberação seguinte a partir da
+// planejada, sem os sleep_ms que prendiam o laço.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "bitdoglab.h"
+#include "led_rgb.h"
+#include "buzzer.h"
+#include "neopixel.h"
+#include "modulo.h"
+#include "sched.h"
+#include "trace_rec.h"
+#include "hot_path.h"
+
+// definições do tempo de cada fase do semáforo
+#define tVerde1 4000
+#define tVerde2 6000
+#define tAmarelo 3000
+#define tVermelho 4000
+#define tVermelhoAdicional 6000
+#define VERIFICA_PEDIDO_MS 100 // no verde flexível
+
+typedef enum estado_semaforo
+{
+    VERDE_OBRIGATORIO,
+    VERDE_FLEXIVEL,
+    AMARELO,
+    VERMELHO
+} estado_semaforo;
+
+static const char *const nomes_fase[] = {"verde", "verde (flexível)", "amarelo", "vermelho"};
+
+static volatile bool solicitacao_pedestre;
+static volatile uint32_t ultimo_acionamento;
+static const uint32_t debounce_time_ms = 50;
+static estado_semaforo estado_atual = VERDE_OBRIGATORIO;
+static uint8_t passo; // dentro da fase
+static bool pedestre_livre;
+static volatile uint32_t geracao;
+
+static const bool sinal_livre[5][5] = { // seta liberando pedestre
+    {0, 0, 1, 0, 0},
+    {0, 1, 1, 1, 0},
+    {1, 0, 1, 0, 1},
+    {0, 0, 1, 0, 0},
+    {0, 0, 1, 0, 0}};
+static const bool sinal_stop[5][5] = { // sinal vermelho para pedestre
+    {0, 1, 1, 1, 0},
+    {1, 0, 0, 0, 1},
+    {1, 0, 0, 0, 1},
+    {1, 0, 0, 0, 1},
+    {0, 1, 1, 1, 0}};
+
+static void avancar(void);
+SCHED_TASK(tarefa_semaforo, "semaforo", avancar, 0, 0, 5); // sem período: cada passo marca o seguinte
+
+//------------- Interrupção dos botões: borda de descida é pedido de pedestre
+static void HOT_PATH(callback_botao)(uint gpio, uint32_t events)
+{
+    (void)gpio; // só o trace usa o pino: os dois botões pedem a travessia
+    TRACE_GPIO(gpio, (events & GPIO_IRQ_EDGE_RISE) != 0);
+    if (!(events & GPIO_IRQ_EDGE_FALL))
+        return;
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    if (agora - ultimo_acionamento > debounce_time_ms)
+    {
+        solicitacao_pedestre = true;
+        ultimo_acionamento = agora;
+    }
+}
+
+//------------- Símbolo do pedestre na matriz, a 30% da intensidade
+static void exibir_sinal_pedestre(bool livre)
+{
+    npShowSymbol(livre ? sinal_livre : sinal_stop, livre ? 0 : 0xFF, livre ? 0xFF : 0, 0);
+    pedestre_livre = livre;
+}
+
+static void mudar_fase(estado_semaforo e)
+{
+    estado_atual = e;
+    passo = 0;
+    geracao++;
+}
+
+//------------- Um passo do ciclo; devolve a espera em ms até o próximo
+static uint32_t passo_ciclo(void)
+{
+    switch (estado_atual)
+    {
+    case VERDE_OBRIGATORIO:
+        if (passo++ == 0)
+        {
+            set_rgb_intensity(0.0f, 0.5f, 0.0f);
+            return tVerde1;
+        }
+        mudar_fase(solicitacao_pedestre ? AMARELO : VERDE_FLEXIVEL);
+        return 0;
+    case VERDE_FLEXIVEL:
+        // Pedido durante o verde flexível adianta o amarelo; verificado a cada 100 ms
+        if (solicitacao_pedestre || passo * VERIFICA_PEDIDO_MS >= tVerde2)
+        {
+            mudar_fase(AMARELO);
+            return 0;
+        }
+        passo++;
+        return VERIFICA_PEDIDO_MS;
+    case AMARELO:
+        if (passo++ == 0)
+        {
+            set_rgb_intensity(0.5f, 0.5f, 0.0f);
+            return tAmarelo;
+        }
+        mudar_fase(VERMELHO);
+        return 0;
+    case VERMELHO:
+        switch (passo++)
+        {
+        case 0: // três bips curtos (sinal aberto)
+            set_rgb_intensity(0.5f, 0.0f, 0.0f);
+            buzzer_on(1000);
+            return 200;
+        case 1:
+        case 3:
+            buzzer_off();
+            return 100;
+        case 2:
+        case 4:
+            buzzer_on(1000);
+            return 200;
+        case 5:
+            buzzer_off();
+            exibir_sinal_pedestre(true);
+            geracao++;
+            return tVermelho;
+        case 6:
+            if (solicitacao_pedestre)
+            {
+                solicitacao_pedestre = false;
+                return tVermelhoAdicional; // tempo adicional para pedestre
+            }
+            return 0;
+        case 7: // fecha para o pedestre antes do semáforo mudar, com um bip longo
+            exibir_sinal_pedestre(false);
+            geracao++;
+            buzzer_on(500);
+            return 800;
+        default:
+            buzzer_off();
+            mudar_fase(VERDE_OBRIGATORIO);
+            return 0;
+        }
+    }
+    return 0;
+}
+
+static void avancar(void)
+{
+    sched_next_ms(&tarefa_semaforo, passo_ciclo());
+}
+
+static void iniciar(void)
+{
+    led_rgb_init();
+    buzzer_init();
+
+    bitdoglab_botao_init(BOTAO_A_PIN);
+    bitdoglab_botao_init(BOTAO_B_PIN);
+    gpio_set_irq_enabled_with_callback(BOTAO_A_PIN, GPIO_IRQ_EDGE_FALL, true, &callback_botao);
+    gpio_set_irq_enabled_with_callback(BOTAO_B_PIN, GPIO_IRQ_EDGE_FALL, true, &callback_botao);
+#if TRACE_REC
+    // Para o replay também precisamos das bordas de subida (soltura do botão)
+    gpio_set_irq_enabled(BOTAO_A_PIN, GPIO_IRQ_EDGE_RISE, true);
+    gpio_set_irq_enabled(BOTAO_B_PIN, GPIO_IRQ_EDGE_RISE, true);
+#endif
+
+    neopixel_init(PIO_NEO_PIN);
+    exibir_sinal_pedestre(false);
+    sched_add(&tarefa_semaforo, 1000); // a matriz mostra "pare" por 1 s antes do primeiro verde
+}
+
+static size_t secao(char *buf, size_t max)
+{
+    int n = snprintf(buf, max,
+                     "<h2>Semáforo</h2>"
+                     "<div class='s %s'>%s</div>"
+                     "<div>Pedestre: %s</div>",
+                     estado_atual == VERMELHO ? "off" : "on", nomes_fase[estado_atual],
+                     pedestre_livre ? "atravesse" : "aguarde");
+    return n < 0 || (size_t)n >= max ? 0 : (size_t)n;
+}
+
+static void telemetria(telemetria_t *t)
+{
+    t->fase = (uint8_t)estado_atual;
+}
+
+const modulo_t modulo_semaforo = {"semaforo", iniciar, secao, telemetria, &geracao};
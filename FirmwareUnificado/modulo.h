@@ -0,0 +1,41 @@
+#ifndef MODULO_H
+#define MODULO_H
+
+// Interface dos módulos do firmware unificado. Cada módulo (botões, joystick,
+// semáforo) é compilado só se a opção MOD_* correspondente estiver ligada no CMake
+// e se registra por aqui: o main chama 'iniciar' uma vez (pinos, grupos de
+// amostragem e tarefas do escalonador), monta a página principal com as seções de
+// todos e junta os campos de cada um num único registro de telemetria.
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Registro de telemetria (/history): um por período, com os campos de todos os
+// módulos; os de módulos desligados ficam em zero
+typedef struct telemetria_t
+{
+    uint32_t t_ms;
+    int16_t temp_centi; // temperatura em centésimos de °C
+    uint8_t botoes;     // bit 0 = botão A, bit 1 = botão B
+    int8_t x;           // joystick, -100 a 100
+    int8_t y;
+    uint8_t direcao;    // direcao_t de joystick_pipeline.h
+    uint8_t sw;         // botão do joystick
+    uint8_t fase;       // fase do semáforo (0 verde obrigatório ... 3 vermelho)
+} telemetria_t;
+
+typedef struct modulo_t
+{
+    const char *nome;
+    void (*iniciar)(void);
+    // Escreve o trecho HTML do módulo na página principal; devolve o tamanho ou 0 se não coube
+    size_t (*secao)(char *buf, size_t max);
+    void (*telemetria)(telemetria_t *t);
+    const volatile uint32_t *geracao; // avança quando algo da seção muda (http_cache)
+} modulo_t;
+
+extern const modulo_t modulo_botoes;
+extern const modulo_t modulo_joystick;
+extern const modulo_t modulo_semaforo;
+
+#endif // MODULO_H
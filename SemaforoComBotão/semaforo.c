@@ -1,22 +1,29 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/pio.h"
-#include "ws2818b.pio.h"
-#include "hardware/pwm.h"
-
-#define LED_RED 13 // Definições do semáforo
-#define LED_GREEN 11
-#define LED_BLUE 12
-#define BOTAO_PEDESTRE_A 5
-#define BOTAO_PEDESTRE_B 6
-
-// Definições da matriz NeoPixel
-#define PIO_NEO_PIN 7 // Pino de controle da matriz
-#define MATRIX_WIDTH 5
-#define MATRIX_HEIGHT 5
-#define LED_COUNT (MATRIX_WIDTH * MATRIX_HEIGHT)
-
-#define BUZZER_PIN 21 // Pino do buzzer
+#include "bitdoglab.h"
+#include "led_rgb.h"
+#include "buzzer.h"
+#include "neopixel.h"
+#include "trace_rec.h"
+#include "mem_stats.h"
+#include "deadline.h"
+#include "profiler.h"
+#include "hot_path.h"
+#include "isr_bench.h"
+#include "cycle_clock.h"
+#include "timesync.h"
+#if TIMESYNC_NTP
+#include "pico/cyw43_arch.h"
+
+// Configurações de Wi-Fi e do servidor NTP
+#define WIFI_SSID "nome"
+#define WIFI_PASSWORD "senha"
+#define NTP_SERVIDOR "pool.ntp.org"
+#endif
+
+// Pinos, LED RGB, buzzer e matriz NeoPixel da BitDogLab (common/bitdoglab)
+#define BOTAO_PEDESTRE_A BOTAO_A_PIN
+#define BOTAO_PEDESTRE_B BOTAO_B_PIN
 
 // definições do tempo de cada fase do semáforo
 #define tVerde1 4000
@@ -24,6 +31,32 @@
 #define tAmarelo 3000
 #define tVermelho 4000
 #define tVermelhoAdicional 6000
+// Ciclo mais longo: pedido no fim do verde flexível e tempo adicional para o pedestre
+#define tCicloMax (tVerde1 + tVerde2 + tAmarelo + 3 * 200 + 2 * 100 + tVermelho + tVermelhoAdicional + 800)
+
+// Grade dos ciclos para coordenação com os semáforos vizinhos (onda verde): com
+// SEMAFORO_CICLO_MS > 0 cada ciclo começa num múltiplo dele no relógio de referência,
+// mais SEMAFORO_DEFASAGEM_MS, e o vermelho se estende até a próxima posição. 0 = ciclos
+// emendados.
+#ifndef SEMAFORO_CICLO_MS
+#define SEMAFORO_CICLO_MS 0
+#endif
+#ifndef SEMAFORO_DEFASAGEM_MS
+#define SEMAFORO_DEFASAGEM_MS 0
+#endif
+#if SEMAFORO_CICLO_MS && SEMAFORO_CICLO_MS < tCicloMax
+#error "SEMAFORO_CICLO_MS precisa comportar o ciclo mais longo (tCicloMax)"
+#endif
+
+// Orçamentos do monitor de prazos (deadline.h): duração planejada de cada fase + folga
+DEADLINE_PHASE(fase_verde_obrigatorio, "verde_obrigatorio", tVerde1 + 20);
+DEADLINE_PHASE(fase_verde_flexivel, "verde_flexivel", tVerde2 + 120); // verifica o botão a cada 100 ms
+DEADLINE_PHASE(fase_amarelo, "amarelo", tAmarelo + 20);
+DEADLINE_PHASE(fase_vermelho, "vermelho", 3 * 200 + 2 * 100 + tVermelho + tVermelhoAdicional + 800 + 50);
+// Um check-in por fase; a maior é o vermelho, ou o verde obrigatório com a espera da grade
+DEADLINE_TASK(tarefa_semaforo, "semaforo", 13000 + SEMAFORO_CICLO_MS);
+// Todos os instantes do ciclo são deslocamentos da mesma época (cycle_clock.h)
+CYCLE_CLOCK(ciclo, "semaforo", SEMAFORO_CICLO_MS, SEMAFORO_DEFASAGEM_MS);
 
 typedef enum estado_semaforo
 { // estados do semaforo
@@ -33,46 +66,22 @@ typedef enum estado_semaforo
     VERMELHO
 } estado_semaforo;
 
-// Definição de pixel GRB
-typedef struct pixel_t
-{
-    uint8_t G, R, B; // Três valores de 8-bits compõem um pixel.
-} pixel_t;
-
-typedef pixel_t npLED_t; // Mudança de nome de "struct pixel_t" para "npLED_t" por clareza.
-
 // variaveis globais
-uint red_slice, green_slice, blue_slice;   // Slices PWM para cada LED
-uint red_channel, green_channel, blue_channel; // Canais PWM
-
 volatile bool solicitacao_pedestre = false;       // flag para solicitação de pedestre
 volatile uint32_t ultimo_acionamento = 0;         // para gerenciar acionamento do botão
 const uint32_t debounce_time_ms = 50;             // Tempo de debounce
 estado_semaforo estado_atual = VERDE_OBRIGATORIO; // inicializa o ciclo do semaforo
-npLED_t leds[LED_COUNT];                          // Buffer de cores dos LEDs da matriz de leds
-// Variáveis para uso da máquina PIO.
-PIO np_pio;
-uint sm;
-
-uint buzzer_slice;     // Slice PWM do buzzer
-uint buzzer_channel;   // Canal PWM do buzzer
+uint32_t inicio_fase = 0;                         // início planejado da fase, em ms desde a época do ciclo
 
 // Protótipos de funções
 void set_pins();
 void set_rgb_color(bool red, bool green, bool blue);
-void set_rgb_intensity(float red, float green, float blue);
 void callback_botao(uint gpio, uint32_t events);
-bool check_button_during_delay(uint32_t delay_ms);
-
-void neopixel_init(uint pin);
-void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b);
-void npClear();
-void npWrite();
-void set_pixel(uint x, uint y, uint8_t r, uint8_t g, uint8_t b);
+uint32_t check_button_until(uint32_t inicio_ms, uint32_t fim_ms);
 bool exibir_sinal_pedestre(bool livre);
-
-void buzzer_set_freq(int frequencia);
-void buzzer_beep(int frequencia, int duration_ms);
+#if TIMESYNC_NTP
+void iniciar_ntp();
+#endif
 
 // Símbolos para pedestres (5x5)
 const bool sinal_livre[5][5] = { // seta liberando pedestre
@@ -90,10 +99,20 @@ const bool sinal_stop[5][5] = { // sinal vermelho para pedestre
 //---------------------------------------- Função principal
 int main()
 {
+    MEM_STATS_INIT(); // Pinta as pilhas (modo STATIC_ALLOC)
+    stdio_init_all(); // UART para os relatórios de memória, prazos e trace
+    DEADLINE_INIT(); // Watchdog; imprime o travamento que causou o último reset
+    PROFILER_INIT(); // Amostragem do PC a ~1 kHz (modo PROFILER)
     set_pins(); // Inicializa pinos
     // configura interrupção para os botões
     gpio_set_irq_enabled_with_callback(BOTAO_PEDESTRE_A, GPIO_IRQ_EDGE_FALL, true, &callback_botao);
     gpio_set_irq_enabled_with_callback(BOTAO_PEDESTRE_B, GPIO_IRQ_EDGE_FALL, true, &callback_botao);
+#if TRACE_REC
+    // Para o replay também precisamos das bordas de subida (soltura do botão)
+    gpio_set_irq_enabled(BOTAO_PEDESTRE_A, GPIO_IRQ_EDGE_RISE, true);
+    gpio_set_irq_enabled(BOTAO_PEDESTRE_B, GPIO_IRQ_EDGE_RISE, true);
+    TRACE_INIT();
+#endif
     // Inicializa matriz de LEDs NeoPixel.
     neopixel_init(PIO_NEO_PIN);
     npClear();
@@ -101,16 +120,32 @@ int main()
     sleep_ms(1000); // Espera 1 segundo
     exibir_sinal_pedestre(false); // Passagem proibida
     npWrite();
+#if TIMESYNC_NTP
+    iniciar_ntp(); // sem rede o semáforo segue no relógio local
+#elif TIMESYNC_LOCAL
+    timesync_local_start(); // referência sintética para testes (replay)
+#endif
+    ISR_BENCH_RUN(); // latência de IRQ com tratador na flash e na SRAM (modo ISR_BENCH)
+    DEADLINE_TASK_START(tarefa_semaforo);
+    cycle_start(&ciclo); // época do primeiro ciclo
     while (1)
     { // loop infinito
+        TRACE_POLL(); // despeja o trace de entradas, se habilitado
+        PROFILER_POLL(); // 'P' despeja o histograma de PCs, 'Z' zera
+        DEADLINE_CHECKIN(tarefa_semaforo);
+        // Cada fase espera até o próprio início planejado; o que as ações gastam
+        // (PWM, matriz, relatórios) não empurra as fases seguintes
         switch (estado_atual)
         {
         case VERDE_OBRIGATORIO:
         {                                      // Fase verde obrigatória 
+            cycle_sleep_until(&ciclo, 0); // início do ciclo (com grade, fim da espera no vermelho)
+            DEADLINE_BEGIN(fase_verde_obrigatorio);
             set_rgb_intensity(0.0f, 0.5f, 0.0f); // Verde a 30% de intensidade
 
-            uint32_t start = to_ms_since_boot(get_absolute_time());
-            while (to_ms_since_boot(get_absolute_time()) - start < tVerde1); // 5 segundos de verde
+            cycle_sleep_until(&ciclo, tVerde1); // 4 segundos de verde
+            DEADLINE_END(fase_verde_obrigatorio);
+            inicio_fase = tVerde1;
 
             // Passa para fase verde opcional ou amarelo(caso tenha solicitação)
             if (solicitacao_pedestre)
@@ -128,71 +163,84 @@ int main()
             // Fase verde que permite interrupções (segundos verificando botões, pedestre pode adiantar amarelo a qualquer momento)
             
             // Se receber solicitação durante fase opcional, muda para amarelo mais cedo
-            if (check_button_during_delay(tVerde2))
-            {
-                estado_atual = AMARELO;
-            }
-            else
-            {
-                estado_atual = AMARELO;
-            }
+            DEADLINE_BEGIN(fase_verde_flexivel);
+            inicio_fase = check_button_until(inicio_fase, inicio_fase + tVerde2);
+            DEADLINE_END(fase_verde_flexivel);
+            estado_atual = AMARELO;
             break;
         }
         case AMARELO:
+            DEADLINE_BEGIN(fase_amarelo);
             set_rgb_intensity(0.5f, 0.5f, 0.0f); // Amarelo (vermelho + verde a 30%)
-            sleep_ms(tAmarelo);
+            inicio_fase += tAmarelo;
+            cycle_sleep_until(&ciclo, inicio_fase);
+            DEADLINE_END(fase_amarelo);
             estado_atual = VERMELHO;
             break;
         case VERMELHO:
+        {
+            DEADLINE_BEGIN(fase_vermelho);
         set_rgb_intensity(0.5f, 0.0f, 0.0f); // Vermelho a 30% de intensidade
-            // Três bips curtos (sinal aberto) (600ms)
-            buzzer_beep(1000, 200);
-            sleep_ms(100);
-            buzzer_beep(1000, 200);
-            sleep_ms(100);
-            buzzer_beep(1000, 200);
+            // Três bips curtos (sinal aberto) (800ms): 200 ms ligado, 100 ms de pausa
+            uint32_t t = inicio_fase;
+            for (int i = 0; i < 3; i++)
+            {
+                if (i > 0)
+                    cycle_sleep_until(&ciclo, t += 100);
+                buzzer_on(1000);
+                cycle_sleep_until(&ciclo, t += 200);
+                buzzer_off();
+            }
             exibir_sinal_pedestre(true); // Pedestre pode atravessar  
-            sleep_ms(tVermelho);           
+            cycle_sleep_until(&ciclo, t += tVermelho);
             if (solicitacao_pedestre)
             {
                 solicitacao_pedestre = false; // Limpa a solicitação
-                sleep_ms(tVermelhoAdicional);               // tempo adicional para pedestre
+                cycle_sleep_until(&ciclo, t += tVermelhoAdicional); // tempo adicional para pedestre
             }
             exibir_sinal_pedestre(false); // Passagem proibida //fecha antes do semáforo mudar
-            buzzer_beep(500, 800); // Um bip longo (sinal fechado) /tempo de seguranca para o sinal de pedestre
+            buzzer_on(500); // Um bip longo (sinal fechado) /tempo de seguranca para o sinal de pedestre
+            cycle_sleep_until(&ciclo, t += 800);
+            buzzer_off();
+            DEADLINE_END(fase_vermelho);
+            cycle_next(&ciclo, t); // a próxima época é o fim planejado deste ciclo
+            MEM_STATS_REPORT(); // uso de memória a cada ciclo completo
+            DEADLINE_REPORT(); // estouros de orçamento por fase
+            cycle_report(&ciclo); // atraso das trocas de fase em relação ao planejado
+            timesync_report();
             estado_atual = VERDE_OBRIGATORIO;
             break;
         }
+        }
+    }
+}
+#if TIMESYNC_NTP
+//------------- Conecta ao Wi-Fi e liga o SNTP; a época do ciclo se ancora na primeira resposta
+void iniciar_ntp()
+{
+    if (cyw43_arch_init())
+    {
+        printf("Erro na inicialização do Wi-Fi\n");
+        return;
+    }
+    cyw43_arch_enable_sta_mode();
+    printf("Conectando a %s...\n", WIFI_SSID);
+    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000))
+    {
+        printf("Falha na conexão Wi-Fi\n");
+        return;
     }
+    timesync_ntp_start(NTP_SERVIDOR);
 }
+#endif
 //------------- Inicializa os pinos do semáforo e dos botões
 void set_pins()
 {
-    // Configuração do LED Vermelho (PWM)
-    gpio_set_function(LED_RED, GPIO_FUNC_PWM);
-    red_slice = pwm_gpio_to_slice_num(LED_RED);
-    red_channel = pwm_gpio_to_channel(LED_RED);
-    // Configuração do LED Verde (PWM)
-    gpio_set_function(LED_GREEN, GPIO_FUNC_PWM);
-    green_slice = pwm_gpio_to_slice_num(LED_GREEN);
-    green_channel = pwm_gpio_to_channel(LED_GREEN);
-    // Configuração do LED Azul (PWM)
-    gpio_set_function(LED_BLUE, GPIO_FUNC_PWM);
-    blue_slice = pwm_gpio_to_slice_num(LED_BLUE);
-    blue_channel = pwm_gpio_to_channel(LED_BLUE);
-
-    // inicializa os 2 botões e configura como entrada
-    gpio_init(BOTAO_PEDESTRE_A);
-    gpio_set_dir(BOTAO_PEDESTRE_A, GPIO_IN);
-    gpio_init(BOTAO_PEDESTRE_B);
-    gpio_set_dir(BOTAO_PEDESTRE_B, GPIO_IN);
-    // garante o nivel logico alto enquanto o botão não for pressionado
-    gpio_pull_up(BOTAO_PEDESTRE_A);
-    gpio_pull_up(BOTAO_PEDESTRE_B);
-    // Configura os pinos dos buzzer como PWM
-    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM); 
-    buzzer_slice = pwm_gpio_to_slice_num(BUZZER_PIN);
-    buzzer_channel = pwm_gpio_to_channel(BUZZER_PIN);
+    led_rgb_init(); // LED RGB em PWM
+    // inicializa os 2 botões como entrada com pull-up (nível alto enquanto não pressionado)
+    bitdoglab_botao_init(BOTAO_PEDESTRE_A);
+    bitdoglab_botao_init(BOTAO_PEDESTRE_B);
+    buzzer_init(); // buzzer em PWM
 }
 //------------- Acende o LED RGB de acordo com a cor
 void set_rgb_color(bool red, bool green, bool blue)
@@ -202,34 +250,13 @@ void set_rgb_color(bool red, bool green, bool blue)
     gpio_put(LED_BLUE, blue);
 }
 
-void set_rgb_intensity(float red, float green, float blue) {
-    // Define a frequência do PWM (ex: 1kHz)
-    // Vermelho (Slice 6)
-    pwm_set_clkdiv(red_slice, 125.0f);    // 125 MHz / 125 = 1 MHz
-    pwm_set_wrap(red_slice, 999);         // 1 MHz / 1000 = 1 kHz
-
-    // Verde (Slice 5)
-    pwm_set_clkdiv(green_slice, 125.0f);
-    pwm_set_wrap(green_slice, 999);
-
-    // Azul (Slice 6)
-    pwm_set_clkdiv(blue_slice, 125.0f); 
-    pwm_set_wrap(blue_slice, 999);
-
-    // Aplica 50% de intensidade (0.5 * 1000 = 500)
-    pwm_set_chan_level(red_slice, red_channel, (uint16_t)(red * 1000 * 1.0f));
-    pwm_set_chan_level(green_slice, green_channel, (uint16_t)(green * 1000 * 1.0f));
-    pwm_set_chan_level(blue_slice, blue_channel, (uint16_t)(blue * 1000 * 1.0f));
-
-    // Habilita os canais PWM
-    pwm_set_enabled(red_slice, true);
-    pwm_set_enabled(green_slice, true);
-    pwm_set_enabled(blue_slice, true);
-}
-
 //------------- Função de callback para interrupção dos botões
-void callback_botao(uint gpio, uint32_t events)
+void HOT_PATH(callback_botao)(uint gpio, uint32_t events)
 {
+    (void)gpio; // só o trace usa o pino: os dois botões pedem a travessia
+    TRACE_GPIO(gpio, (events & GPIO_IRQ_EDGE_RISE) != 0);
+    if (!(events & GPIO_IRQ_EDGE_FALL))
+        return; // só a borda de descida conta como solicitação
     uint32_t agora = to_ms_since_boot(get_absolute_time());
     // Verifica se o tempo desde o último acionamento é maior que o debounce
     if (agora - ultimo_acionamento > debounce_time_ms)
@@ -238,131 +265,26 @@ void callback_botao(uint gpio, uint32_t events)
         ultimo_acionamento = agora;
     }
 }
-//------------- Verifica se o botão foi pressionado durante um delay e retorna true se foi
-bool check_button_during_delay(uint32_t delay_ms)
+//------------- Consulta o botão a cada 100 ms da época do ciclo entre inicio_ms e fim_ms;
+// retorna o instante planejado em que a fase acaba (o da consulta que viu o pedido)
+uint32_t check_button_until(uint32_t inicio_ms, uint32_t fim_ms)
 {
-    uint32_t tempo_inicio = to_ms_since_boot(get_absolute_time());
-    while (to_ms_since_boot(get_absolute_time()) - tempo_inicio < delay_ms)
+    for (uint32_t t = inicio_ms; t < fim_ms; t += 100)
     {
+        cycle_sleep_until(&ciclo, t);
         if (solicitacao_pedestre)
         { // botáo foi pressionado
-            return true;
+            return t;
         }
-        sleep_ms(100); // verifica a cada 100ms
     }
-    return false; // botão não foi pressionado
-}
-
-//------------- Inicializa a máquina PIO para controle da matriz de LEDs.
-void neopixel_init(uint pin)
-{
-    // Cria programa PIO.
-    uint offset = pio_add_program(pio0, &ws2818b_program);
-    np_pio = pio0;
-
-    // Toma posse de uma máquina PIO.
-    sm = pio_claim_unused_sm(np_pio, false);
-    if (sm < 0)
-    {
-        np_pio = pio1;
-        sm = pio_claim_unused_sm(np_pio, true); // Se nenhuma máquina estiver livre, panic!
-    }
-    // Inicia programa na máquina PIO obtida.
-    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
-    // Limpa buffer de pixels.
-    for (uint i = 0; i < LED_COUNT; ++i)
-    {
-        leds[i].R = 0;
-        leds[i].G = 0;
-        leds[i].B = 0;
-    }
-}
-
-//------------- Atribui uma cor RGB a um LED da matriz, reduzindo para 30% de intensidade
-void npSetLED(const uint index, const uint8_t r, const uint8_t g, const uint8_t b)
-{
-    // Aplica redução de 30% usando operações inteiras
-    leds[index].R = (r * 3) / 10;
-    leds[index].G = (g * 3) / 10;
-    leds[index].B = (b * 3) / 10;
-
-}
-
-//------------- Limpa o buffer de pixels.
-void npClear()
-{
-    for (uint i = 0; i < LED_COUNT; ++i)
-        npSetLED(i, 0, 0, 0);
-}
-
-//------------- Escreve os dados do buffer nos LEDs.
-void npWrite()
-{
-    // Escreve cada dado de 8-bits dos pixels em sequência no buffer da máquina PIO.
-    for (uint i = 0; i < LED_COUNT; ++i)
-    {
-        pio_sm_put_blocking(np_pio, sm, leds[i].G);
-        pio_sm_put_blocking(np_pio, sm, leds[i].R);
-        pio_sm_put_blocking(np_pio, sm, leds[i].B);
-    }
-    sleep_us(100); // Espera 100us, sinal de RESET do datasheet.
-}
-
-//------------- Define a cor de um led
-void set_pixel(uint x, uint y, uint8_t r, uint8_t g, uint8_t b)
-{
-    if (x >= MATRIX_WIDTH || y >= MATRIX_HEIGHT)
-        return;
-    int index = y * MATRIX_WIDTH + x;
-    npSetLED(index, r, g, b);
+    cycle_sleep_until(&ciclo, fim_ms);
+    return fim_ms; // botão não foi pressionado
 }
 
 //------------- exibe o símbolo do pedestre na matriz de leds
 bool exibir_sinal_pedestre(bool livre)
 {
-    const bool(*sinal)[5] = livre ? sinal_livre : sinal_stop;
     uint32_t color = livre ? 0x00FF00 : 0xFF0000; // Verde ou Vermelho (formato 0xRRGGBB)
-
-    // Extrai componentes de cor
-    uint8_t r = (color >> 16) & 0xFF;
-    uint8_t g = (color >> 8) & 0xFF;
-    uint8_t b = color & 0xFF;
-
-    npClear();
-    for (int y = 0; y < 5; y++)
-    {
-        for (int x = 0; x < 5; x++)
-        {
-            if (sinal[y][x])
-            {
-                set_pixel(x, 4 - y, r, g, b);
-            } // 4 - y corrige inversão da matriz
-        }
-    }
-    npWrite();
+    npShowSymbol(livre ? sinal_livre : sinal_stop, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
     return true;
 }
-
-void buzzer_set_freq(int frequencia) { 
-    if (frequencia <= 0) {
-        pwm_set_enabled(buzzer_slice, false);
-        return;
-    }
-    uint32_t clock = 125000000; // Clock do sistema (125 MHz)
-    uint32_t divider16 = clock / (frequencia * 4096) + 1;
-    if (divider16 / 16 == 0) divider16 = 1;
-    uint32_t wrap = (clock * 16) / (divider16 * frequencia) - 1;
-
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv_int_frac(&config, divider16 / 16, divider16 % 16);
-    pwm_config_set_wrap(&config, wrap);
-    pwm_init(buzzer_slice, &config, true);
-    pwm_set_chan_level(buzzer_slice, buzzer_channel, wrap / 2); // 50% duty cycle
-}
-
-void buzzer_beep(int frequencia, int duration_ms) {
-    buzzer_set_freq(frequencia);
-    pwm_set_enabled(buzzer_slice, true);
-    sleep_ms(duration_ms);
-    pwm_set_enabled(buzzer_slice, false);
-}
\ No newline at end of file
@@ -7,15 +7,24 @@
 #include "lwip/pbuf.h"
 #include "lwip/tcp.h"
 #include "lwip/netif.h"
+#include "trace_rec.h"
+#include "mem_stats.h"
+#include "http_stream.h"
+#include "http_cache.h"
+#include "history.h"
+#include "deadline.h"
+#include "profiler.h"
+#include "isr_bench.h"
+#include "bitdoglab.h"
 
 // Configurações de Wi-Fi
 #define WIFI_SSID "nome"
 #define WIFI_PASSWORD "senha"
 
-// Definição dos pinos
-#define BUTTON1_PIN 5    // GPIO5 - Botão A
-#define BUTTON2_PIN 6    // GPIO6 - Botão B
-#define DEBOUNCE_DELAY_MS 50
+// Definição dos pinos (debounce e conversão da temperatura em common/bitdoglab)
+#define BUTTON1_PIN BOTAO_A_PIN
+#define BUTTON2_PIN BOTAO_B_PIN
+#define HISTORY_CAPACITY 1024 // amostras (~100 s com o laço de 100 ms)
 
 // Estrutura para armazenar o estado dos botões e temperatura
 typedef struct {
@@ -25,8 +34,24 @@ typedef struct {
     absolute_time_t last_update;
 } device_state_t;
 
+// Amostra guardada no histórico: compacta, sem float
+typedef struct {
+    uint32_t t_ms;
+    int16_t temp_centi;  // temperatura em centésimos de °C
+    uint8_t buttons;     // bit 0 = botão 1, bit 1 = botão 2
+} history_sample_t;
+
 // Variáveis globais
 device_state_t current_state = {false, false, 0.0};
+static uint32_t state_generation; // avança quando algo exibido na página muda (http_cache)
+HISTORY_DECLARE(history, history_sample_t, HISTORY_CAPACITY);
+
+// Orçamentos do monitor de prazos (deadline.h)
+DEADLINE_PHASE(phase_wifi, "wifi_connect", 20500);     // timeout do connect + folga
+DEADLINE_PHASE(phase_loop, "laco", 120);               // sleep de 100 ms + trabalho
+DEADLINE_PHASE(phase_update, "update_device_state", 10); // inclui o printf de depuração
+DEADLINE_PHASE(phase_poll, "cyw43_arch_poll", 5);
+DEADLINE_TASK(task_loop, "laco", 1000);
 static bool last_button1_state = false;
 static bool last_button2_state = false;
 static absolute_time_t last_button1_time = 0;
@@ -34,43 +59,35 @@ static absolute_time_t last_button2_time = 0;
 
 // Protótipos de funções
 static float read_temperature();
-static bool debounce_button(int pin, bool *last_state, absolute_time_t *last_time);
 static void update_device_state();
+static void record_history_sample();
+static size_t render_page(char *buf, size_t max);
 static err_t tcp_client_connected(void *arg, struct tcp_pcb *tpcb, err_t err);
 static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
 
-// Função de debounce para os botões
-static bool debounce_button(int pin, bool *last_state, absolute_time_t *last_time) {
-    absolute_time_t now = get_absolute_time();
-    bool current_state = !gpio_get(pin); // Lê o estado invertido (pull-up)
-    
-    if (current_state != *last_state) {
-        *last_time = now;
-        *last_state = current_state;
-        return current_state;
-    }
-    
-    if (absolute_time_diff_us(*last_time, now) > DEBOUNCE_DELAY_MS * 1000) {
-        *last_state = current_state;
-    }
-    
-    return *last_state;
-}
+HTTP_CACHE_DECLARE(page_cache, "pagina", render_page);
 
 // Lê a temperatura do sensor interno
 static float read_temperature() {
-    adc_select_input(4);
+    adc_select_input(TEMPERATURA_ADC);
     uint16_t raw_value = adc_read();
-    const float conversion_factor = 3.3f / (1 << 12);
-    return 27.0f - ((raw_value * conversion_factor - 0.706f) / 0.001721f);
+    TRACE_ADC(TEMPERATURA_ADC, raw_value);
+    return bitdoglab_temperatura(raw_value);
 }
 
 // Atualiza o estado dos dispositivos com debounce
 static void update_device_state() {
-    current_state.button1_pressed = debounce_button(BUTTON1_PIN, &last_button1_state, &last_button1_time);
-    current_state.button2_pressed = debounce_button(BUTTON2_PIN, &last_button2_state, &last_button2_time);
-    current_state.temperature = read_temperature();
+    bool b1 = debounce_button(BUTTON1_PIN, &last_button1_state, &last_button1_time);
+    bool b2 = debounce_button(BUTTON2_PIN, &last_button2_state, &last_button2_time);
+    float temperature = read_temperature();
+    bool mudou = b1 != current_state.button1_pressed || b2 != current_state.button2_pressed ||
+                 temperature != current_state.temperature;
+    current_state.button1_pressed = b1;
+    current_state.button2_pressed = b2;
+    current_state.temperature = temperature;
     current_state.last_update = get_absolute_time();
+    if (mudou)
+        state_generation++; // depois dos campos: a página renderizada nunca é mais velha que a geração
     
     printf("[DEBUG] B1: %d (GPIO: %d), B2: %d (GPIO: %d), Temp: %.2f°C\n",
            current_state.button1_pressed, gpio_get(BUTTON1_PIN),
@@ -78,18 +95,60 @@ static void update_device_state() {
            current_state.temperature);
 }
 
-// Callback para recebimento de dados no servidor
-static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    if (!p) {
-        tcp_close(tpcb);
-        tcp_recv(tpcb, NULL);
-        return ERR_OK;
+// Guarda o estado atual no histórico servido em /history
+static void record_history_sample() {
+    float t = current_state.temperature * 100.0f;
+    history_sample_t s = {
+        .t_ms = to_ms_since_boot(current_state.last_update),
+        .temp_centi = (int16_t)(t < 0 ? t - 0.5f : t + 0.5f),
+        .buttons = (current_state.button1_pressed ? 1 : 0) | (current_state.button2_pressed ? 2 : 0),
+    };
+    history_push(&history, &s);
+}
+
+// Uma amostra do histórico como linha CSV ou registro binário de 12 bytes (little-endian):
+// seq u32, t_ms u32, temp_centi i16, botões u8, reservado u8
+static size_t format_history_sample(const void *amostra, uint32_t seq, bool binario, char *buf, size_t max) {
+    const history_sample_t *s = amostra;
+    if (binario) {
+        if (max < 12)
+            return 0;
+        memcpy(buf, &seq, 4);
+        memcpy(buf + 4, &s->t_ms, 4);
+        memcpy(buf + 8, &s->temp_centi, 2);
+        buf[10] = (char)s->buttons;
+        buf[11] = 0;
+        return 12;
     }
+    char linha[48];
+    int t = s->temp_centi < 0 ? -s->temp_centi : s->temp_centi;
+    int n = snprintf(linha, sizeof(linha), "%lu,%lu,%d,%d,%s%d.%02d\n",
+                     (unsigned long)seq, (unsigned long)s->t_ms, s->buttons & 1, (s->buttons >> 1) & 1,
+                     s->temp_centi < 0 ? "-" : "", t / 100, t % 100);
+    if (n < 0 || (size_t)n > max)
+        return 0;
+    memcpy(buf, linha, n);
+    return n;
+}
+
+// GET /history?since=<seq>&fmt=csv|bin: resposta chunked gerada conforme o TCP libera espaço
+static err_t serve_history(struct tcp_pcb *tpcb, const char *alvo) {
+    history_stream_t estado;
+    history_stream_init(&estado, &history, format_history_sample, "seq,t_ms,botao1,botao2,temperatura\n", alvo);
+    TRACE_HTTP(estado.binario ? TRACE_HTTP_HISTORY_BIN : TRACE_HTTP_HISTORY_CSV, estado.seq);
 
-    update_device_state(); // Atualiza estado antes de responder
+    char extra[40];
+    snprintf(extra, sizeof(extra), "X-History-Next: %lu\r\n", (unsigned long)estado.fim);
+    err_t e = http_stream_start(tpcb, estado.binario ? "application/octet-stream" : "text/csv", extra,
+                                history_stream_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
 
-    char html[2048];
-    snprintf(html, sizeof(html),
+// Página principal com o estado atual; renderizada uma vez por geração (http_cache)
+static size_t render_page(char *buf, size_t max) {
+    int n = snprintf(buf, max,
         "HTTP/1.1 200 OK\r\n"
         "Content-Type: text/html; charset=UTF-8\r\n"
         "Connection: close\r\n\r\n"
@@ -118,10 +177,54 @@ static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, er
         current_state.button2_pressed ? "pressed" : "released",
         current_state.button2_pressed ? "Ativo" : "Inativo",
         current_state.temperature);
+    return n < 0 || (size_t)n >= max ? 0 : (size_t)n;
+}
+
+#if PROFILER
+// GET /profile[?reset=1]: histograma de PCs no mesmo formato do dump pela UART
+static err_t serve_profile(struct tcp_pcb *tpcb, const char *alvo) {
+    char valor[4];
+    if (http_query_param(alvo, "reset", valor, sizeof(valor)) && strcmp(valor, "1") == 0)
+        profiler_reset();
+    profiler_stream_t estado;
+    profiler_stream_init(&estado);
+    err_t e = http_stream_start(tpcb, "text/plain", NULL, profiler_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
+#endif
+
+// Callback para recebimento de dados no servidor
+static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    if (!p) {
+        tcp_close(tpcb);
+        tcp_recv(tpcb, NULL);
+        return ERR_OK;
+    }
+
+    char alvo[64];
+    if (http_request_target(p, alvo, sizeof(alvo))) {
+        if (http_path_is(alvo, "/history")) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+            return serve_history(tpcb, alvo);
+        }
+#if PROFILER
+        if (http_path_is(alvo, "/profile")) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+            return serve_profile(tpcb, alvo);
+        }
+#endif
+    }
 
-    tcp_write(tpcb, html, strlen(html), TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
+    TRACE_HTTP(TRACE_HTTP_ROOT, 0);
+    tcp_recved(tpcb, p->tot_len);
     pbuf_free(p);
+    // Estado do último laço: todos os clientes da mesma geração recebem o mesmo buffer
+    if (http_cache_send(&page_cache, tpcb, state_generation) == ERR_MEM)
+        return http_stream_busy(tpcb);
     return ERR_OK;
 }
 
@@ -132,7 +235,10 @@ static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
 }
 
 int main() {
+    MEM_STATS_INIT(); // Pinta as pilhas (modo STATIC_ALLOC)
     stdio_init_all();
+    DEADLINE_INIT(); // Watchdog; imprime o travamento que causou o último reset
+    PROFILER_INIT(); // Amostragem do PC a ~1 kHz (modo PROFILER)
     printf("Inicializando sistema...\n");
 
     // Configuração de GPIO
@@ -155,7 +261,10 @@ int main() {
     cyw43_arch_enable_sta_mode();
 
     printf("Conectando a %s...\n", WIFI_SSID);
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000)) {
+    DEADLINE_BEGIN(phase_wifi);
+    int falha_wifi = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000);
+    DEADLINE_END(phase_wifi);
+    if (falha_wifi) {
         printf("Falha na conexão Wi-Fi\n");
         return 1;
     }
@@ -168,12 +277,31 @@ int main() {
     tcp_accept(pcb, tcp_server_accept);
 
     printf("Servidor web iniciado na porta 80\n");
+    TRACE_INIT();
 
     // Loop principal
+    ISR_BENCH_RUN(); // latência de IRQ com tratador na flash e na SRAM (modo ISR_BENCH)
+    uint32_t iteracao = 0;
+    DEADLINE_TASK_START(task_loop);
     while (true) {
+        DEADLINE_CHECKIN(task_loop);
+        TRACE_POLL(); // despejos pela UART ficam fora da fase do laço
+        PROFILER_POLL();
+        DEADLINE_BEGIN(phase_loop);
+        DEADLINE_BEGIN(phase_update);
         update_device_state();
+        DEADLINE_END(phase_update);
+        record_history_sample();
+        DEADLINE_BEGIN(phase_poll);
         cyw43_arch_poll();
+        DEADLINE_END(phase_poll);
+        if (++iteracao % 100 == 0) {
+            MEM_STATS_REPORT(); // uso de memória a cada ~10 s
+            DEADLINE_REPORT();
+            http_cache_report(&page_cache);
+        }
         sleep_ms(100); // Verificação mais rápida para melhor resposta
+        DEADLINE_END(phase_loop);
     }
 
     cyw43_arch_deinit();
@@ -7,6 +7,17 @@
 #include "lwip/pbuf.h"
 #include "lwip/tcp.h"
 #include "lwip/netif.h"
+#include "trace_rec.h"
+#include "mem_stats.h"
+#include "hardware/sync.h"
+#include "joystick_pipeline.h"
+#include "http_stream.h"
+#include "http_cache.h"
+#include "history.h"
+#include "deadline.h"
+#include "profiler.h"
+#include "hot_path.h"
+#include "isr_bench.h"
 
 // Configurações de Wi-Fi
 #define WIFI_SSID "nome"
@@ -17,76 +28,137 @@
 #define JOYSTICK_X_PIN 27  // GPIO27 - VRx
 #define JOYSTICK_SW_PIN 22 // GPIO22 - Botão SW
 
-// Thresholds para determinar a posição do joystick
-#define JOYSTICK_CENTER_MIN 1800
-#define JOYSTICK_CENTER_MAX 2200
+// Amostragem do joystick: timer de 1 kHz alimentando o pipeline de joystick_pipeline.c
+#define JOYSTICK_SAMPLE_HZ 1000
+#define JOYSTICK_TRACE_DECIMACAO 10 // grava 1 a cada 10 amostras no trace (100 Hz)
+#define HISTORY_CAPACITY 1024       // leituras guardadas (~100 s com o laço de 100 ms)
 
 // Estrutura para armazenar os dados do joystick
 typedef struct {
-    uint16_t x_raw;
+    uint16_t x_raw;      // valor filtrado de cada eixo
     uint16_t y_raw;
-    int x_position;
+    int x_position;      // -100 a 100, relativo ao centro calibrado
     int y_position;
     bool button_pressed;
-    char direction[10];  // Norte, Sul, Leste, Oeste, etc.
+    direcao_t direction; // texto só na hora de exibir (joystick_direcao_nome)
 } joystick_data_t;
 
-// Função para ler o joystick e determinar a direção
-void read_joystick(joystick_data_t *data) {
-    // Leitura do eixo X (VRx - GPIO27)
+// Leitura guardada no histórico servido em /history
+typedef struct {
+    uint32_t t_ms;
+    int8_t x;           // -100 a 100
+    int8_t y;
+    uint8_t direction;  // direcao_t
+    uint8_t button;
+} history_sample_t;
+
+static joystick_pipeline_t joystick;      // atualizado na interrupção do timer
+static repeating_timer_t timer_joystick;
+HISTORY_DECLARE(history, history_sample_t, HISTORY_CAPACITY);
+static joystick_data_t page_data;        // leitura exibida na página, do laço principal
+static uint32_t page_generation;         // avança quando page_data muda (http_cache)
+static size_t render_page(char *buf, size_t max);
+HTTP_CACHE_DECLARE(page_cache, "pagina", render_page);
+
+// Orçamentos do monitor de prazos (deadline.h)
+DEADLINE_PHASE(phase_wifi, "wifi_connect", 20500);  // timeout do connect + folga
+DEADLINE_PHASE(phase_loop, "laco", 120);            // sleep de 100 ms + trabalho
+DEADLINE_PHASE(phase_console, "printf_console", 10); // ~80 caracteres a 115200 baud
+DEADLINE_PHASE(phase_poll, "cyw43_arch_poll", 5);
+DEADLINE_TASK(task_loop, "laco", 1000);
+DEADLINE_TASK(task_sampling, "amostragem", 50);     // check-in no timer de 1 kHz
+
+// Callback do timer: lê os dois eixos e processa a amostra
+static bool HOT_PATH(amostrar_joystick)(repeating_timer_t *t) {
+    (void)t;
     adc_select_input(1);  // ADC1 - Eixo X (GPIO27)
-    data->x_raw = adc_read();
-    
-    // Leitura do eixo Y (VRy - GPIO26)
+    uint16_t x = adc_read();
     adc_select_input(0);  // ADC0 - Eixo Y (GPIO26)
-    data->y_raw = adc_read();
-    
-    // Leitura do botão SW
-    data->button_pressed = !gpio_get(JOYSTICK_SW_PIN);  // Botão normalmente está em HIGH, LOW quando pressionado
-    
-    // Convertendo para posições relativas (-100 a 100)
-    data->x_position = ((int)data->x_raw - 2048) * 100 / 2048;
-    data->y_position = ((int)data->y_raw - 2048) * 100 / 2048;
-    
-    // Determinar a direção com base nos valores do joystick
-    if (data->x_raw < JOYSTICK_CENTER_MIN && data->y_raw < JOYSTICK_CENTER_MIN) {
-        strcpy(data->direction, "Sudoeste");
-    } else if (data->x_raw < JOYSTICK_CENTER_MIN && data->y_raw > JOYSTICK_CENTER_MAX) {
-        strcpy(data->direction, "Noroeste");
-    } else if (data->x_raw > JOYSTICK_CENTER_MAX && data->y_raw < JOYSTICK_CENTER_MIN) {
-        strcpy(data->direction, "Sudeste");
-    } else if (data->x_raw > JOYSTICK_CENTER_MAX && data->y_raw > JOYSTICK_CENTER_MAX) {
-        strcpy(data->direction, "Nordeste");
-    } else if (data->x_raw < JOYSTICK_CENTER_MIN) {
-        strcpy(data->direction, "Oeste");
-    } else if (data->x_raw > JOYSTICK_CENTER_MAX) {
-        strcpy(data->direction, "Leste");
-    } else if (data->y_raw < JOYSTICK_CENTER_MIN) {
-        strcpy(data->direction, "Sul");
-    } else if (data->y_raw > JOYSTICK_CENTER_MAX) {
-        strcpy(data->direction, "Norte");
-    } else {
-        strcpy(data->direction, "Centro");
+    uint16_t y = adc_read();
+
+    if (joystick.amostras % JOYSTICK_TRACE_DECIMACAO == 0) {
+        TRACE_ADC(1, x);
+        TRACE_ADC(0, y);
     }
+    joystick_pipeline_update(&joystick, x, y);
+    DEADLINE_CHECKIN(task_sampling);
+    return true;
 }
 
-// Função de callback para processar requisições HTTP
-static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
-    if (!p) {
-        tcp_close(tpcb);
-        tcp_recv(tpcb, NULL);
-        return ERR_OK;
+// Função para ler o estado atual do joystick (já filtrado e classificado)
+void read_joystick(joystick_data_t *data) {
+    uint32_t irq = save_and_disable_interrupts();
+    data->x_raw = joystick_eixo_filtrado(&joystick.x);
+    data->y_raw = joystick_eixo_filtrado(&joystick.y);
+    data->x_position = joystick_percentual(joystick.nx);
+    data->y_position = joystick_percentual(joystick.ny);
+    data->direction = joystick.direcao;
+    restore_interrupts(irq);
+
+    // Leitura do botão SW
+    bool nivel = gpio_get(JOYSTICK_SW_PIN);
+    TRACE_GPIO(JOYSTICK_SW_PIN, nivel);
+    data->button_pressed = !nivel;  // Botão normalmente está em HIGH, LOW quando pressionado
+}
+
+// Guarda uma leitura no histórico
+static void record_history_sample(const joystick_data_t *data) {
+    history_sample_t s = {
+        .t_ms = to_ms_since_boot(get_absolute_time()),
+        .x = (int8_t)data->x_position,
+        .y = (int8_t)data->y_position,
+        .direction = (uint8_t)data->direction,
+        .button = data->button_pressed,
+    };
+    history_push(&history, &s);
+}
+
+// Uma leitura como linha CSV ou registro binário de 12 bytes (little-endian):
+// seq u32, t_ms u32, x i8, y i8, direção u8 (direcao_t), botão u8
+static size_t format_history_sample(const void *amostra, uint32_t seq, bool binario, char *buf, size_t max) {
+    const history_sample_t *s = amostra;
+    if (binario) {
+        if (max < 12)
+            return 0;
+        memcpy(buf, &seq, 4);
+        memcpy(buf + 4, &s->t_ms, 4);
+        buf[8] = (char)s->x;
+        buf[9] = (char)s->y;
+        buf[10] = (char)s->direction;
+        buf[11] = (char)s->button;
+        return 12;
     }
+    char linha[48];
+    int n = snprintf(linha, sizeof(linha), "%lu,%lu,%d,%d,%s,%d\n",
+                     (unsigned long)seq, (unsigned long)s->t_ms, s->x, s->y,
+                     joystick_direcao_nome((direcao_t)s->direction), s->button);
+    if (n < 0 || (size_t)n > max)
+        return 0;
+    memcpy(buf, linha, n);
+    return n;
+}
 
-    // Leitura do joystick
-    joystick_data_t joystick_data;
-    read_joystick(&joystick_data);
+// GET /history?since=<seq>&fmt=csv|bin: resposta chunked gerada conforme o TCP libera espaço
+static err_t serve_history(struct tcp_pcb *tpcb, const char *alvo) {
+    history_stream_t estado;
+    history_stream_init(&estado, &history, format_history_sample, "seq,t_ms,x,y,direcao,botao\n", alvo);
+    TRACE_HTTP(estado.binario ? TRACE_HTTP_HISTORY_BIN : TRACE_HTTP_HISTORY_CSV, estado.seq);
 
-    // Cria a resposta HTML
-    char html[1024];
-    snprintf(html, sizeof(html),
+    char extra[40];
+    snprintf(extra, sizeof(extra), "X-History-Next: %lu\r\n", (unsigned long)estado.fim);
+    err_t e = http_stream_start(tpcb, estado.binario ? "application/octet-stream" : "text/csv", extra,
+                                history_stream_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
+
+// Página principal com a última leitura; renderizada uma vez por geração (http_cache)
+static size_t render_page(char *buf, size_t max) {
+    int n = snprintf(buf, max,
              "HTTP/1.1 200 OK\r\n"
              "Content-Type: text/html; charset=UTF-8\r\n"
+             "Connection: close\r\n"
              "\r\n"
              "<!DOCTYPE html>\n"
              "<html>\n"
@@ -113,13 +185,66 @@ static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, er
         	    "</script>\n"
              "</body>\n"
              "</html>\n",
-             joystick_data.x_position, joystick_data.y_position, joystick_data.direction);
+             page_data.x_position, page_data.y_position, joystick_direcao_nome(page_data.direction));
+    return n < 0 || (size_t)n >= max ? 0 : (size_t)n;
+}
 
-    tcp_write(tpcb, html, strlen(html), TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
+// Publica a leitura para a página; só muda a geração se algo exibido mudou
+static void update_page_data(const joystick_data_t *data) {
+    if (data->x_position == page_data.x_position && data->y_position == page_data.y_position &&
+        data->direction == page_data.direction)
+        return;
+    uint32_t irq = save_and_disable_interrupts(); // a renderização roda no callback do lwIP
+    page_data = *data;
+    page_generation++;
+    restore_interrupts(irq);
+}
 
-    pbuf_free(p);
+#if PROFILER
+// GET /profile[?reset=1]: histograma de PCs no mesmo formato do dump pela UART
+static err_t serve_profile(struct tcp_pcb *tpcb, const char *alvo) {
+    char valor[4];
+    if (http_query_param(alvo, "reset", valor, sizeof(valor)) && strcmp(valor, "1") == 0)
+        profiler_reset();
+    profiler_stream_t estado;
+    profiler_stream_init(&estado);
+    err_t e = http_stream_start(tpcb, "text/plain", NULL, profiler_gerar, &estado, sizeof(estado));
+    if (e == ERR_MEM)
+        return http_stream_busy(tpcb);
+    return e;
+}
+#endif
 
+// Função de callback para processar requisições HTTP
+static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    if (!p) {
+        tcp_close(tpcb);
+        tcp_recv(tpcb, NULL);
+        return ERR_OK;
+    }
+
+    char alvo[64];
+    if (http_request_target(p, alvo, sizeof(alvo))) {
+        if (http_path_is(alvo, "/history")) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+            return serve_history(tpcb, alvo);
+        }
+#if PROFILER
+        if (http_path_is(alvo, "/profile")) {
+            tcp_recved(tpcb, p->tot_len);
+            pbuf_free(p);
+            return serve_profile(tpcb, alvo);
+        }
+#endif
+    }
+
+    TRACE_HTTP(TRACE_HTTP_ROOT, 0);
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+    // Leitura do último laço: todos os clientes da mesma geração recebem o mesmo buffer
+    if (http_cache_send(&page_cache, tpcb, page_generation) == ERR_MEM)
+        return http_stream_busy(tpcb);
     return ERR_OK;
 }
 
@@ -131,6 +256,7 @@ static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
 
 // Função principal
 int main() {
+    MEM_STATS_INIT(); // Pinta as pilhas (modo STATIC_ALLOC)
     stdio_init_all();
     
     // Configuração do botão do joystick como entrada com pull-up
@@ -143,6 +269,13 @@ int main() {
     adc_gpio_init(JOYSTICK_X_PIN);  // Configura GPIO para ADC (eixo X - VRx)
     adc_gpio_init(JOYSTICK_Y_PIN);  // Configura GPIO para ADC (eixo Y - VRy)
 
+    // Começa a amostrar já: as primeiras amostras calibram o centro com o joystick em repouso
+    joystick_pipeline_init(&joystick);
+    DEADLINE_INIT(); // Watchdog; imprime o travamento que causou o último reset
+    PROFILER_INIT(); // Amostragem do PC a ~1 kHz (modo PROFILER)
+    DEADLINE_TASK_START(task_sampling);
+    add_repeating_timer_us(-1000000 / JOYSTICK_SAMPLE_HZ, amostrar_joystick, NULL, &timer_joystick);
+
     // Inicializa Wi-Fi
     while (cyw43_arch_init()) {
         printf("Falha ao inicializar Wi-Fi\n");
@@ -153,7 +286,10 @@ int main() {
     cyw43_arch_enable_sta_mode();
 
     printf("Conectando ao Wi-Fi...\n");
-    while (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000)) {
+    DEADLINE_BEGIN(phase_wifi);
+    int falha_wifi = cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000);
+    DEADLINE_END(phase_wifi);
+    while (falha_wifi) {
         printf("Falha ao conectar ao Wi-Fi\n");
         sleep_ms(100);
         return -1;
@@ -181,18 +317,38 @@ int main() {
     tcp_accept(server, tcp_server_accept);
 
     printf("Servidor ouvindo na porta 80\n");
+    TRACE_INIT();
 
     // Loop principal
+    ISR_BENCH_RUN(); // latência de IRQ com tratador na flash e na SRAM (modo ISR_BENCH)
+    uint32_t iteracao = 0;
+    DEADLINE_TASK_START(task_loop);
     while (true) {
+        DEADLINE_CHECKIN(task_loop);
+        TRACE_POLL(); // despejos pela UART ficam fora da fase do laço
+        PROFILER_POLL();
+        DEADLINE_BEGIN(phase_loop);
         // Teste de leitura do joystick no console
         joystick_data_t test_data;
         read_joystick(&test_data);
+        record_history_sample(&test_data);
+        update_page_data(&test_data);
+        DEADLINE_BEGIN(phase_console);
         printf("Joystick - X: %d, Y: %d, Direção: %s, Botão: %s\n", 
-               test_data.x_position, test_data.y_position, test_data.direction,
+               test_data.x_position, test_data.y_position, joystick_direcao_nome(test_data.direction),
                test_data.button_pressed ? "Pressionado" : "Não pressionado");
+        DEADLINE_END(phase_console);
         
+        DEADLINE_BEGIN(phase_poll);
         cyw43_arch_poll();
+        DEADLINE_END(phase_poll);
+        if (++iteracao % 100 == 0) {
+            MEM_STATS_REPORT(); // uso de memória a cada ~10 s
+            DEADLINE_REPORT();
+            http_cache_report(&page_cache);
+        }
         sleep_ms(100);  // Pequeno delay para não sobrecarregar o console
+        DEADLINE_END(phase_loop);
     }
 
     cyw43_arch_deinit();
@@ -0,0 +1,145 @@
+#include "joystick_pipeline.h"
+#include "hot_path.h"
+
+#define CAL_AMOSTRAS   64   // amostras iniciais usadas para achar o centro (joystick em repouso)
+#define EXT_INICIAL    400  // extensão mínima: cresce até o curso real de cada lado
+#define IIR_SHIFT      3    // alfa = 1/8: constante de tempo de ~8 amostras
+
+// Zona morta radial em Q8: entra no centro abaixo de 12%, só sai acima de 18%
+#define ZONA_ENTRA_Q8  31
+#define ZONA_SAI_Q8    46
+
+// tan(22,5°) em Q8: fronteira entre eixo e diagonal
+#define TAN_22_5_Q8    106
+// cos²(22,5° + 5°) em Q8: a direção atual se mantém até 5° além da fronteira
+#define COS2_SETOR_Q8  201
+
+// Vetores unitários de cada octante em Q8
+static const int16_t unit_x[8] = {256, 181, 0, -181, -256, -181, 0, 181};
+static const int16_t unit_y[8] = {0, 181, 256, 181, 0, -181, -256, -181};
+
+static const char *const nomes[] = {
+    [DIR_LESTE] = "Leste",
+    [DIR_NORDESTE] = "Nordeste",
+    [DIR_NORTE] = "Norte",
+    [DIR_NOROESTE] = "Noroeste",
+    [DIR_OESTE] = "Oeste",
+    [DIR_SUDOESTE] = "Sudoeste",
+    [DIR_SUL] = "Sul",
+    [DIR_SUDESTE] = "Sudeste",
+    [DIR_CENTRO] = "Centro",
+};
+
+const char *joystick_direcao_nome(direcao_t d)
+{
+    return d <= DIR_CENTRO ? nomes[d] : "?";
+}
+
+static void eixo_init(joystick_eixo_t *e)
+{
+    *e = (joystick_eixo_t){
+        .hist = {2048, 2048, 2048},
+        .iir = 2048 << 4,
+        .centro = 2048,
+        .ext_pos = EXT_INICIAL,
+        .ext_neg = EXT_INICIAL,
+        .inv_pos = (1 << 24) / EXT_INICIAL,
+        .inv_neg = (1 << 24) / EXT_INICIAL,
+    };
+}
+
+void joystick_pipeline_init(joystick_pipeline_t *p)
+{
+    eixo_init(&p->x);
+    eixo_init(&p->y);
+    p->amostras = 0;
+    p->idx_hist = 0;
+    p->nx = p->ny = 0;
+    p->direcao = DIR_CENTRO;
+}
+
+static inline uint16_t mediana3(uint16_t a, uint16_t b, uint16_t c)
+{
+    if (a > b) { uint16_t t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+// Filtra uma amostra e devolve a posição normalizada em Q8
+static int16_t HOT_PATH(eixo_update)(joystick_eixo_t *e, uint16_t raw, uint32_t n, uint8_t idx)
+{
+    e->hist[idx] = raw;
+    int32_t med = mediana3(e->hist[0], e->hist[1], e->hist[2]);
+
+    if (n < CAL_AMOSTRAS)
+    { // calibração: acumula o centro e mantém o filtro acompanhando
+        e->soma += med;
+        e->iir = med << 4;
+        if (n == CAL_AMOSTRAS - 1)
+        {
+            e->centro = (int32_t)(e->soma / CAL_AMOSTRAS);
+            e->iir = e->centro << 4;
+        }
+        return 0;
+    }
+
+    e->iir += ((med << 4) - e->iir) >> IIR_SHIFT;
+    int32_t d = (e->iir >> 4) - e->centro;
+
+    // As extensões partem de um curso curto e crescem até os picos vistos, então um
+    // eixo de curso curto também chega a 100%; a divisão só acontece num novo máximo
+    if (d > e->ext_pos)
+    {
+        e->ext_pos = d;
+        e->inv_pos = (1 << 24) / d;
+    }
+    else if (-d > e->ext_neg)
+    {
+        e->ext_neg = -d;
+        e->inv_neg = (1 << 24) / -d;
+    }
+    return (int16_t)(d >= 0 ? (d * e->inv_pos) >> 16 : -((-d * e->inv_neg) >> 16));
+}
+
+static direcao_t HOT_PATH(octante)(int32_t nx, int32_t ny)
+{
+    int32_t ax = nx < 0 ? -nx : nx;
+    int32_t ay = ny < 0 ? -ny : ny;
+    if (ay * 256 < ax * TAN_22_5_Q8)
+        return nx >= 0 ? DIR_LESTE : DIR_OESTE;
+    if (ax * 256 < ay * TAN_22_5_Q8)
+        return ny >= 0 ? DIR_NORTE : DIR_SUL;
+    if (nx >= 0)
+        return ny >= 0 ? DIR_NORDESTE : DIR_SUDESTE;
+    return ny >= 0 ? DIR_NOROESTE : DIR_SUDOESTE;
+}
+
+static direcao_t HOT_PATH(classificar)(int32_t nx, int32_t ny, direcao_t atual)
+{
+    int32_t r2 = nx * nx + ny * ny; // Q16
+    int32_t limite = atual == DIR_CENTRO ? ZONA_SAI_Q8 : ZONA_ENTRA_Q8;
+    if (r2 < limite * limite)
+        return DIR_CENTRO;
+
+    if (atual != DIR_CENTRO)
+    { // histerese angular: continua na direção atual se estiver no setor alargado
+        int32_t dot = nx * unit_x[atual] + ny * unit_y[atual]; // Q16
+        if (dot > 0 && (int64_t)dot * dot > ((int64_t)r2 * COS2_SETOR_Q8) << 8)
+            return atual;
+    }
+    return octante(nx, ny);
+}
+
+//------------- Processa uma amostra dos dois eixos (pode ser chamada de interrupção)
+void HOT_PATH(joystick_pipeline_update)(joystick_pipeline_t *p, uint16_t x_raw, uint16_t y_raw)
+{
+    int16_t nx = eixo_update(&p->x, x_raw, p->amostras, p->idx_hist);
+    int16_t ny = eixo_update(&p->y, y_raw, p->amostras, p->idx_hist);
+    p->idx_hist = p->idx_hist == 2 ? 0 : p->idx_hist + 1;
+    if (p->amostras != UINT32_MAX)
+        p->amostras++;
+
+    p->nx = nx > 256 ? 256 : nx < -256 ? -256 : nx;
+    p->ny = ny > 256 ? 256 : ny < -256 ? -256 : ny;
+    p->direcao = classificar(p->nx, p->ny, p->direcao);
+}
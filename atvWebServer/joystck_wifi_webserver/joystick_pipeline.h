@@ -0,0 +1,63 @@
+#ifndef JOYSTICK_PIPELINE_H
+#define JOYSTICK_PIPELINE_H
+
+// Processamento das leituras do joystick, só com inteiros (barato o bastante para
+// amostrar a 1 kHz dentro de uma interrupção de timer):
+//   mediana de 3 -> IIR de 1ª ordem (Q4) -> calibração de centro/extensões ->
+//   normalização em Q8 (-256..256) -> zona morta radial com histerese ->
+//   octante por comparação com tan(22,5°) e histerese angular.
+// A direção é um enum; o texto só é gerado na hora de exibir.
+
+#include <stdint.h>
+
+typedef enum direcao_t
+{
+    DIR_LESTE,    // 0°
+    DIR_NORDESTE, // 45°
+    DIR_NORTE,    // 90°
+    DIR_NOROESTE,
+    DIR_OESTE,
+    DIR_SUDOESTE,
+    DIR_SUL,
+    DIR_SUDESTE,
+    DIR_CENTRO
+} direcao_t;
+
+typedef struct joystick_eixo_t
+{
+    uint16_t hist[3];   // últimas 3 amostras brutas (mediana)
+    int32_t iir;        // valor filtrado em Q4
+    int32_t centro;     // LSB do ADC
+    int32_t ext_pos;    // maior deslocamento já visto acima/abaixo do centro
+    int32_t ext_neg;
+    int32_t inv_pos;    // 2^24 / extensão: normaliza com multiplicação em vez de divisão
+    int32_t inv_neg;
+    uint32_t soma;      // acumulador da calibração do centro
+} joystick_eixo_t;
+
+typedef struct joystick_pipeline_t
+{
+    joystick_eixo_t x, y;
+    uint32_t amostras;  // satura em UINT32_MAX (não recalibra após dar a volta)
+    uint8_t idx_hist;
+    int16_t nx, ny;     // posição normalizada em Q8
+    direcao_t direcao;
+} joystick_pipeline_t;
+
+void joystick_pipeline_init(joystick_pipeline_t *p);
+void joystick_pipeline_update(joystick_pipeline_t *p, uint16_t x_raw, uint16_t y_raw);
+const char *joystick_direcao_nome(direcao_t d);
+
+// Valor filtrado do eixo, em LSB do ADC
+static inline uint16_t joystick_eixo_filtrado(const joystick_eixo_t *e)
+{
+    return (uint16_t)(e->iir >> 4);
+}
+
+// Posição em porcentagem (-100 a 100) a partir do valor em Q8
+static inline int joystick_percentual(int16_t n_q8)
+{
+    return (n_q8 * 100) / 256;
+}
+
+#endif // JOYSTICK_PIPELINE_H
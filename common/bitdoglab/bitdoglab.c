@@ -0,0 +1,28 @@
+#include "bitdoglab.h"
+#include "trace_rec.h"
+#include "hot_path.h"
+
+//------------- Debounce de um botão com pull-up
+bool HOT_PATH(debounce_button)(int pin, bool *last_state, absolute_time_t *last_time)
+{
+    absolute_time_t now = get_absolute_time();
+    bool nivel = gpio_get(pin);
+    TRACE_GPIO(pin, nivel);
+    bool current_state = !nivel; // Lê o estado invertido (pull-up)
+
+    if (current_state != *last_state)
+    {
+        *last_time = now;
+        *last_state = current_state;
+        return current_state;
+    }
+    if (absolute_time_diff_us(*last_time, now) > DEBOUNCE_DELAY_MS * 1000)
+        *last_state = current_state;
+    return *last_state;
+}
+
+float bitdoglab_temperatura(uint16_t raw)
+{
+    const float conversion_factor = 3.3f / (1 << 12);
+    return 27.0f - ((raw * conversion_factor - 0.706f) / 0.001721f);
+}
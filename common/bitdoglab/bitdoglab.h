@@ -0,0 +1,43 @@
+#ifndef BITDOGLAB_H
+#define BITDOGLAB_H
+
+// Pinos e acessórios da BitDogLab compartilhados pelos firmwares (semáforo, servidores
+// web e firmware unificado). Os botões A e B são compartilhados no firmware unificado:
+// o monitor de botões lê o nível e o semáforo usa a borda de descida como pedido de
+// pedestre. Os drivers do LED RGB, do buzzer e da matriz NeoPixel ficam em led_rgb.h,
+// buzzer.h e neopixel.h.
+
+#include "pico/stdlib.h"
+
+#define BOTAO_A_PIN 5      // GPIO5 - Botão A
+#define BOTAO_B_PIN 6      // GPIO6 - Botão B
+#define JOYSTICK_SW_PIN 22 // GPIO22 - botão SW do joystick
+#define JOYSTICK_X_PIN 27  // GPIO27 - VRx
+#define JOYSTICK_Y_PIN 26  // GPIO26 - VRy
+#define JOYSTICK_X_ADC 1   // ADC1 (GPIO27)
+#define JOYSTICK_Y_ADC 0   // ADC0 (GPIO26)
+#define TEMPERATURA_ADC 4  // sensor interno
+#define LED_RED 13         // LED RGB (PWM)
+#define LED_GREEN 11
+#define LED_BLUE 12
+#define PIO_NEO_PIN 7      // matriz NeoPixel 5x5
+#define BUZZER_PIN 21
+
+#define DEBOUNCE_DELAY_MS 50
+
+// Botão com pull-up (nível baixo = pressionado); chamar de novo para o mesmo pino não muda nada
+static inline void bitdoglab_botao_init(uint pino)
+{
+    gpio_init(pino);
+    gpio_set_dir(pino, GPIO_IN);
+    gpio_pull_up(pino);
+}
+
+// Estado do botão com debounce: uma mudança vale na hora, a volta só depois de
+// DEBOUNCE_DELAY_MS estável. 'last_state' e 'last_time' são do chamador, um par por botão.
+bool debounce_button(int pin, bool *last_state, absolute_time_t *last_time);
+
+// Leitura crua de 12 bits do sensor interno (TEMPERATURA_ADC) em °C
+float bitdoglab_temperatura(uint16_t raw);
+
+#endif // BITDOGLAB_H
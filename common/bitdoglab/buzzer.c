@@ -0,0 +1,38 @@
+#include "hardware/pwm.h"
+#include "bitdoglab.h"
+#include "buzzer.h"
+
+static uint buzzer_slice;   // Slice PWM do buzzer
+static uint buzzer_channel; // Canal PWM do buzzer
+
+void buzzer_init(void)
+{
+    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
+    buzzer_slice = pwm_gpio_to_slice_num(BUZZER_PIN);
+    buzzer_channel = pwm_gpio_to_channel(BUZZER_PIN);
+}
+
+void buzzer_on(int frequencia)
+{
+    if (frequencia <= 0)
+    {
+        buzzer_off();
+        return;
+    }
+    uint32_t clock = 125000000; // Clock do sistema (125 MHz)
+    uint32_t divider16 = clock / (frequencia * 4096) + 1;
+    if (divider16 / 16 == 0)
+        divider16 = 1;
+    uint32_t wrap = (clock * 16) / (divider16 * frequencia) - 1;
+
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv_int_frac(&config, divider16 / 16, divider16 % 16);
+    pwm_config_set_wrap(&config, wrap);
+    pwm_init(buzzer_slice, &config, true);
+    pwm_set_chan_level(buzzer_slice, buzzer_channel, wrap / 2); // 50% duty cycle
+}
+
+void buzzer_off(void)
+{
+    pwm_set_enabled(buzzer_slice, false);
+}
@@ -0,0 +1,13 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+// Buzzer da BitDogLab (BUZZER_PIN) em PWM com 50% de ciclo; a duração do bip é de
+// quem chama, entre buzzer_on e buzzer_off
+
+void buzzer_init(void);
+
+// Liga na frequência em Hz (<= 0 desliga)
+void buzzer_on(int frequencia);
+void buzzer_off(void);
+
+#endif // BUZZER_H
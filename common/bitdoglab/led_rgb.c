@@ -0,0 +1,35 @@
+#include "hardware/pwm.h"
+#include "bitdoglab.h"
+#include "led_rgb.h"
+
+static uint red_slice, green_slice, blue_slice;       // Slices PWM para cada LED
+static uint red_channel, green_channel, blue_channel; // Canais PWM
+
+void led_rgb_init(void)
+{
+    gpio_set_function(LED_RED, GPIO_FUNC_PWM);
+    red_slice = pwm_gpio_to_slice_num(LED_RED);
+    red_channel = pwm_gpio_to_channel(LED_RED);
+    gpio_set_function(LED_GREEN, GPIO_FUNC_PWM);
+    green_slice = pwm_gpio_to_slice_num(LED_GREEN);
+    green_channel = pwm_gpio_to_channel(LED_GREEN);
+    gpio_set_function(LED_BLUE, GPIO_FUNC_PWM);
+    blue_slice = pwm_gpio_to_slice_num(LED_BLUE);
+    blue_channel = pwm_gpio_to_channel(LED_BLUE);
+}
+
+void set_rgb_intensity(float red, float green, float blue)
+{
+    pwm_set_clkdiv(red_slice, 125.0f); // 125 MHz / 125 = 1 MHz
+    pwm_set_wrap(red_slice, 999);      // 1 MHz / 1000 = 1 kHz
+    pwm_set_clkdiv(green_slice, 125.0f);
+    pwm_set_wrap(green_slice, 999);
+    pwm_set_clkdiv(blue_slice, 125.0f);
+    pwm_set_wrap(blue_slice, 999);
+    pwm_set_chan_level(red_slice, red_channel, (uint16_t)(red * 1000));
+    pwm_set_chan_level(green_slice, green_channel, (uint16_t)(green * 1000));
+    pwm_set_chan_level(blue_slice, blue_channel, (uint16_t)(blue * 1000));
+    pwm_set_enabled(red_slice, true);
+    pwm_set_enabled(green_slice, true);
+    pwm_set_enabled(blue_slice, true);
+}
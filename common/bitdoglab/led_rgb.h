@@ -0,0 +1,12 @@
+#ifndef LED_RGB_H
+#define LED_RGB_H
+
+// LED RGB da BitDogLab (LED_RED, LED_GREEN, LED_BLUE) em PWM de 1 kHz
+
+// Põe os três pinos em PWM
+void led_rgb_init(void);
+
+// Intensidade de cada cor, de 0.0 a 1.0
+void set_rgb_intensity(float red, float green, float blue);
+
+#endif // LED_RGB_H
@@ -0,0 +1,72 @@
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "ws2818b.pio.h"
+#include "neopixel.h"
+#include "deadline.h"
+#include "hot_path.h"
+
+// Definição de pixel GRB
+typedef struct pixel_t
+{
+    uint8_t G, R, B; // Três valores de 8-bits compõem um pixel.
+} npLED_t;
+
+static npLED_t leds[LED_COUNT]; // Buffer de cores dos LEDs da matriz
+static PIO np_pio;
+static uint sm;
+
+DEADLINE_PHASE(fase_np_write, "npWrite", 2); // 75 bytes a 800 kHz + reset de 100 us
+
+//------------- Inicializa a máquina PIO para controle da matriz de LEDs.
+void neopixel_init(uint pin)
+{
+    uint offset = pio_add_program(pio0, &ws2818b_program);
+    np_pio = pio0;
+    int livre = pio_claim_unused_sm(np_pio, false);
+    if (livre < 0)
+    {
+        np_pio = pio1;
+        livre = pio_claim_unused_sm(np_pio, true); // se nenhuma máquina estiver livre, panic!
+    }
+    sm = (uint)livre;
+    ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+    npClear();
+}
+
+void npSetLED(uint index, uint8_t r, uint8_t g, uint8_t b)
+{
+    // Aplica redução de 30% usando operações inteiras
+    leds[index].R = (r * 3) / 10;
+    leds[index].G = (g * 3) / 10;
+    leds[index].B = (b * 3) / 10;
+}
+
+void npClear(void)
+{
+    for (uint i = 0; i < LED_COUNT; ++i)
+        npSetLED(i, 0, 0, 0);
+}
+
+void HOT_PATH(npWrite)(void)
+{
+    DEADLINE_BEGIN(fase_np_write); // um PIO travado em pio_sm_put_blocking aparece aqui
+    for (uint i = 0; i < LED_COUNT; ++i)
+    {
+        pio_sm_put_blocking(np_pio, sm, leds[i].G);
+        pio_sm_put_blocking(np_pio, sm, leds[i].R);
+        pio_sm_put_blocking(np_pio, sm, leds[i].B);
+    }
+    sleep_us(100); // sinal de RESET do datasheet
+    DEADLINE_END(fase_np_write);
+}
+
+void npShowSymbol(const bool simbolo[MATRIX_HEIGHT][MATRIX_WIDTH], uint8_t r, uint8_t g, uint8_t b)
+{
+    for (uint y = 0; y < MATRIX_HEIGHT; y++)
+        for (uint x = 0; x < MATRIX_WIDTH; x++)
+        {
+            bool aceso = simbolo[MATRIX_HEIGHT - 1 - y][x]; // a linha 0 da matriz fica embaixo
+            npSetLED(y * MATRIX_WIDTH + x, aceso ? r : 0, aceso ? g : 0, aceso ? b : 0);
+        }
+    npWrite();
+}
@@ -0,0 +1,28 @@
+#ifndef NEOPIXEL_H
+#define NEOPIXEL_H
+
+// Matriz NeoPixel 5x5 da BitDogLab numa máquina PIO (ws2818b.pio). As cores ficam num
+// buffer e só vão para os LEDs em npWrite.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+#define MATRIX_WIDTH 5
+#define MATRIX_HEIGHT 5
+#define LED_COUNT (MATRIX_WIDTH * MATRIX_HEIGHT)
+
+// Carrega o programa no PIO0 (ou PIO1, se não houver máquina livre) e limpa o buffer
+void neopixel_init(uint pin);
+
+// Cor de um LED no buffer, reduzida para 30% da intensidade
+void npSetLED(uint index, uint8_t r, uint8_t g, uint8_t b);
+void npClear(void);
+
+// Envia o buffer para a matriz (~1 ms: 75 bytes a 800 kHz + reset)
+void npWrite(void);
+
+// Desenha um símbolo 5x5 (linha 0 em cima) numa cor, apaga o resto e envia
+void npShowSymbol(const bool simbolo[MATRIX_HEIGHT][MATRIX_WIDTH], uint8_t r, uint8_t g, uint8_t b);
+
+#endif // NEOPIXEL_H
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "cycle_clock.h"
+#include "timesync.h"
+
+// Primeira posição da grade em ou depois de ref_us
+static uint64_t na_grade(const cycle_clock_t *c, uint64_t ref_us)
+{
+    if (!c->grade_ms)
+        return ref_us;
+    uint64_t grade = (uint64_t)c->grade_ms * 1000u, fase = (uint64_t)c->defasagem_ms * 1000u;
+    if (ref_us <= fase)
+        return fase;
+    uint64_t k = (ref_us - fase + grade - 1) / grade;
+    return k * grade + fase;
+}
+
+static void ancorar(cycle_clock_t *c)
+{
+    c->saltos_sync = timesync_steps();
+    c->epoca_ref_us = na_grade(c, timesync_to_ref(time_us_64()));
+    c->epoca_us = timesync_to_local(c->epoca_ref_us);
+}
+
+void cycle_start(cycle_clock_t *c)
+{
+    ancorar(c);
+}
+
+void cycle_sleep_until(cycle_clock_t *c, uint32_t deslocamento_ms)
+{
+    uint64_t alvo = c->epoca_us + (uint64_t)deslocamento_ms * 1000u;
+    sleep_until(from_us_since_boot(alvo));
+    uint64_t agora = time_us_64();
+    uint32_t atraso = agora > alvo ? (uint32_t)(agora - alvo) : 0;
+    c->instantes++;
+    c->soma_atraso_us += atraso;
+    if (atraso > c->pior_atraso_us)
+        c->pior_atraso_us = atraso;
+    int b = atraso < 10 ? 0 : atraso < 100 ? 1 : atraso < 1000 ? 2 : atraso < 10000 ? 3 : 4;
+    c->hist[b]++;
+}
+
+//------------- Próxima época: emenda na referência e converte para o relógio local
+void cycle_next(cycle_clock_t *c, uint32_t duracao_ms)
+{
+    c->ciclos++;
+    if (timesync_steps() != c->saltos_sync)
+    { // o mapeamento saltou (primeira sincronização): a época antiga não vale na referência
+        c->reancoragens++;
+        ancorar(c);
+        return;
+    }
+    uint64_t ref_anterior = c->epoca_ref_us, local_anterior = c->epoca_us;
+    c->epoca_ref_us = na_grade(c, ref_anterior + (uint64_t)duracao_ms * 1000u);
+    c->epoca_us = timesync_to_local(c->epoca_ref_us);
+    // Diferença entre o intervalo no relógio local e na referência: a correção de
+    // frequência da sincronização (zero sem TIME_SYNC)
+    int64_t correcao = (int64_t)(c->epoca_us - local_anterior) - (int64_t)(c->epoca_ref_us - ref_anterior);
+    if (correcao < 0)
+        correcao = -correcao;
+    if (correcao > c->pior_correcao_us)
+        c->pior_correcao_us = correcao > INT32_MAX ? INT32_MAX : (int32_t)correcao;
+}
+
+void cycle_report(const cycle_clock_t *c)
+{
+    printf("[CICLO] %s ciclos=%lu reancoragens=%lu instantes=%lu atraso med=%lu us pior=%lu us "
+           "hist(<10us,<100us,<1ms,<10ms,>=10ms)=%lu,%lu,%lu,%lu,%lu correcao_max=%ld us\n",
+           c->nome, (unsigned long)c->ciclos, (unsigned long)c->reancoragens, (unsigned long)c->instantes,
+           (unsigned long)(c->instantes ? c->soma_atraso_us / c->instantes : 0), (unsigned long)c->pior_atraso_us,
+           (unsigned long)c->hist[0], (unsigned long)c->hist[1], (unsigned long)c->hist[2],
+           (unsigned long)c->hist[3], (unsigned long)c->hist[4], (long)c->pior_correcao_us);
+}
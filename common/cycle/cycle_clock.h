@@ -0,0 +1,58 @@
+#ifndef CYCLE_CLOCK_H
+#define CYCLE_CLOCK_H
+
+// Relógio de ciclo: cada instante de um ciclo (troca de fase, bip, consulta ao botão)
+// é um deslocamento em ms a partir de uma única época, e a espera vai até esse
+// instante absoluto em vez de somar sleeps. O tempo gasto entre as esperas (PWM,
+// matriz de LEDs, relatórios) não se acumula: o ciclo seguinte começa na época
+// anterior + a duração planejada, e não no fim da última ação.
+//
+// A época é planejada no relógio de referência (timesync.h) e convertida para o
+// relógio local no início de cada ciclo, então a correção de frequência da fonte
+// de tempo entra entre ciclos. Com 'grade_ms' os ciclos começam só em múltiplos da
+// grade na referência (+ 'defasagem_ms'): semáforos vizinhos sincronizados com a
+// mesma grade mantêm a onda verde. Um salto do mapeamento (primeira sincronização)
+// reancora a época na próxima posição da grade.
+//
+// Medições: atraso de cada instante (real - planejado) em histograma, médio e pior,
+// e a maior correção da época aplicada pela sincronização.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CYCLE_HIST_BUCKETS 5 // atraso < 10 us, 100 us, 1 ms, 10 ms e >= 10 ms
+
+typedef struct cycle_clock_t
+{
+    const char *nome;
+    uint32_t grade_ms;      // 0 = ciclos emendados, sem grade
+    uint32_t defasagem_ms;  // posição na grade (onda verde)
+    uint64_t epoca_ref_us;  // início planejado do ciclo atual na referência
+    uint64_t epoca_us;      // o mesmo instante no relógio local
+    uint32_t saltos_sync;   // timesync_steps() quando a época foi ancorada
+    uint32_t ciclos;
+    uint32_t reancoragens;
+    uint32_t instantes;
+    uint64_t soma_atraso_us;
+    uint32_t pior_atraso_us;
+    uint32_t hist[CYCLE_HIST_BUCKETS];
+    int32_t pior_correcao_us; // maior |ciclo no relógio local - ciclo na referência|
+} cycle_clock_t;
+
+#define CYCLE_CLOCK(var, nome_ciclo, grade, defasagem) \
+    static cycle_clock_t var = {.nome = (nome_ciclo), .grade_ms = (grade), .defasagem_ms = (defasagem)}
+
+// Ancora a primeira época: agora ou, com grade, a próxima posição dela
+void cycle_start(cycle_clock_t *c);
+
+// Dorme até a época + 'deslocamento_ms' e registra o atraso ao acordar
+void cycle_sleep_until(cycle_clock_t *c, uint32_t deslocamento_ms);
+
+// Fecha o ciclo que durou 'duracao_ms' planejados: a próxima época é a atual +
+// duração (arredondada para cima na grade)
+void cycle_next(cycle_clock_t *c, uint32_t duracao_ms);
+
+// Ciclos, instantes, atraso médio e pior, histograma e maior correção (cumulativo)
+void cycle_report(const cycle_clock_t *c);
+
+#endif // CYCLE_CLOCK_H
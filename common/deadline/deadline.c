@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "deadline.h"
+#include "hot_path.h"
+
+// Registradores de scratch 0..3 do watchdog (o SDK usa 4..7 no watchdog_reboot)
+#define SCRATCH_ASSINATURA 0
+#define SCRATCH_FASE       1
+#define SCRATCH_TAREFA     2
+#define SCRATCH_TEMPOS     3
+#define ASSINATURA         0x574Bu // "WK" nos 16 bits altos; os baixos contam os resets
+
+#define BARREIRA() __asm volatile("" ::: "memory")
+
+static deadline_phase_t *volatile fase_atual; // mais interna em andamento
+static deadline_phase_t *fases;                // todas as já usadas, para o relatório
+static deadline_task_t *volatile tarefas;
+static repeating_timer_t timer_supervisor;
+static volatile bool travado;
+static volatile uint32_t pausas;  // DEADLINE_PAUSE aninhados em andamento
+static volatile uint32_t pausa_us; // início da pausa mais externa
+
+// Travamento anterior lido dos registradores de scratch no boot
+static struct
+{
+    uint16_t resets;
+    const char *fase;
+    const char *tarefa;
+    uint16_t fase_ms;
+    uint16_t tarefa_ms;
+} anterior;
+
+static uint16_t saturar_ms(uint32_t us)
+{
+    uint32_t ms = us / 1000;
+    return ms > 0xffff ? 0xffff : (uint16_t)ms;
+}
+
+// Os nomes são literais em flash: o ponteiro continua válido depois do reset
+// enquanto o firmware for o mesmo
+static const char *nome_valido(uint32_t p)
+{
+#ifdef XIP_BASE
+    if (p < XIP_BASE || p >= XIP_BASE + PICO_FLASH_SIZE_BYTES)
+        return NULL;
+#endif
+    return (const char *)(uintptr_t)p;
+}
+
+//------------- Grava a causa do travamento e deixa o watchdog vencer (em interrupção)
+static void registrar_travamento(const deadline_phase_t *f, const deadline_task_t *t, uint32_t agora)
+{
+    watchdog_hw->scratch[SCRATCH_ASSINATURA] = (ASSINATURA << 16) | (uint16_t)(anterior.resets + 1);
+    watchdog_hw->scratch[SCRATCH_FASE] = f ? (uint32_t)(uintptr_t)f->nome : 0;
+    watchdog_hw->scratch[SCRATCH_TAREFA] = t ? (uint32_t)(uintptr_t)t->nome : 0;
+    watchdog_hw->scratch[SCRATCH_TEMPOS] = ((uint32_t)(f ? saturar_ms(agora - f->inicio_us) : 0) << 16) |
+                                           (t ? saturar_ms(agora - t->ultimo_us) : 0);
+    travado = true;
+}
+
+//------------- Timer de supervisão: só alimenta o watchdog se está tudo em dia
+static bool HOT_PATH(supervisionar)(repeating_timer_t *rt)
+{
+    (void)rt;
+    if (travado)
+        return true; // sem alimentar: o watchdog reinicia a placa
+    uint32_t agora = time_us_32();
+    deadline_phase_t *f = fase_atual;
+    if (pausas)
+    { // despejo em andamento: prazos suspensos, mas não para sempre
+        if (agora - pausa_us > DEADLINE_PAUSE_MAX_MS * 1000u)
+            registrar_travamento(f, NULL, agora);
+        else
+            watchdog_update();
+        return true;
+    }
+    for (deadline_task_t *t = tarefas; t; t = t->proxima)
+    {
+        if (agora - t->ultimo_us > t->intervalo_us)
+        { // a fase ativa é onde o laço principal está parado
+            registrar_travamento(f, t, agora);
+            return true;
+        }
+    }
+    if (f && agora - f->inicio_us > f->orcamento_us + DEADLINE_STALL_MARGIN_MS * 1000u)
+    {
+        registrar_travamento(f, NULL, agora);
+        return true;
+    }
+    watchdog_update();
+    return true;
+}
+
+static void imprimir_anterior(void)
+{
+    if (!anterior.resets)
+        return;
+    printf("[DEADLINE] reset pelo watchdog (%u até agora): fase %s há %u ms, tarefa %s sem check-in há %u ms\n",
+           anterior.resets, anterior.fase ? anterior.fase : "-", anterior.fase_ms,
+           anterior.tarefa ? anterior.tarefa : "-", anterior.tarefa_ms);
+}
+
+//------------- Lê o relatório do reset anterior e liga watchdog e supervisão
+void deadline_init(void)
+{
+    uint32_t assinatura = watchdog_hw->scratch[SCRATCH_ASSINATURA];
+    if (watchdog_enable_caused_reboot() && (assinatura >> 16) == ASSINATURA)
+    {
+        anterior.resets = (uint16_t)assinatura;
+        anterior.fase = nome_valido(watchdog_hw->scratch[SCRATCH_FASE]);
+        anterior.tarefa = nome_valido(watchdog_hw->scratch[SCRATCH_TAREFA]);
+        anterior.fase_ms = (uint16_t)(watchdog_hw->scratch[SCRATCH_TEMPOS] >> 16);
+        anterior.tarefa_ms = (uint16_t)watchdog_hw->scratch[SCRATCH_TEMPOS];
+    }
+    watchdog_hw->scratch[SCRATCH_ASSINATURA] = 0;
+    imprimir_anterior();
+
+    watchdog_enable(DEADLINE_WATCHDOG_MS, true); // pausa no depurador
+    add_repeating_timer_ms(-DEADLINE_SUPERVISOR_MS, supervisionar, NULL, &timer_supervisor);
+}
+
+void deadline_begin(deadline_phase_t *f)
+{
+    if (!f->registrada)
+    {
+        f->registrada = true;
+        f->proxima = fases;
+        fases = f;
+    }
+    f->inicio_us = time_us_32();
+    f->anterior = fase_atual;
+    BARREIRA(); // o supervisor só pode ver a fase com o início já gravado
+    fase_atual = f;
+}
+
+//------------- Fecha a fase e contabiliza o tempo gasto contra o orçamento
+void deadline_end(deadline_phase_t *f)
+{
+    uint32_t gasto = time_us_32() - f->inicio_us;
+    fase_atual = f->anterior;
+
+    f->execucoes++;
+    if (gasto > f->pior_us)
+        f->pior_us = gasto;
+    if (gasto > f->orcamento_us)
+    {
+        uint32_t excesso = gasto - f->orcamento_us;
+        int b = 0;
+        while (b < DEADLINE_HIST_BUCKETS - 1 && excesso >= (1000u << b))
+            b++;
+        f->estouros++;
+        f->hist[b]++;
+    }
+}
+
+void deadline_task_start(deadline_task_t *t)
+{
+    t->ultimo_us = time_us_32();
+    uint32_t irq = save_and_disable_interrupts(); // o supervisor percorre a lista
+    t->proxima = tarefas;
+    tarefas = t;
+    restore_interrupts(irq);
+}
+
+void HOT_PATH(deadline_checkin)(deadline_task_t *t)
+{
+    t->ultimo_us = time_us_32();
+}
+
+//------------- Suspende os prazos durante um despejo longo (pode aninhar)
+void deadline_pause(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    if (!pausas++)
+        pausa_us = time_us_32();
+    restore_interrupts(irq);
+}
+
+//------------- Retoma os prazos; o tempo pausado é descontado das fases abertas e das tarefas
+void deadline_resume(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    if (pausas && !--pausas)
+    {
+        uint32_t pausado = time_us_32() - pausa_us;
+        for (deadline_phase_t *f = fase_atual; f; f = f->anterior)
+            f->inicio_us += pausado;
+        for (deadline_task_t *t = tarefas; t; t = t->proxima)
+            t->ultimo_us += pausado;
+    }
+    restore_interrupts(irq);
+}
+
+//------------- Imprime orçamento, estouros e histograma do excesso de cada fase
+void deadline_report(void)
+{
+    imprimir_anterior();
+    printf("[DEADLINE] %-20s %8s %8s %8s %9s | excesso <1 <2 <4 <8 <16 <32 <64 >=64 ms\n",
+           "fase", "orç ms", "exec", "estouros", "pior ms");
+    for (const deadline_phase_t *f = fases; f; f = f->proxima)
+    {
+        printf("[DEADLINE] %-20s %8lu %8lu %8lu %5lu.%03lu |        ",
+               f->nome, (unsigned long)(f->orcamento_us / 1000), (unsigned long)f->execucoes,
+               (unsigned long)f->estouros, (unsigned long)(f->pior_us / 1000), (unsigned long)(f->pior_us % 1000));
+        for (int b = 0; b < DEADLINE_HIST_BUCKETS; b++)
+            printf(" %lu", (unsigned long)f->hist[b]);
+        printf("\n");
+    }
+}
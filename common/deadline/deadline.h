@@ -0,0 +1,105 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+// Monitor de prazos com watchdog de hardware:
+//  - cada fase (iteração do laço, estado do semáforo, função suspeita) declara um
+//    orçamento; ao terminar, o tempo gasto entra nas estatísticas da fase e os
+//    estouros vão para um histograma do excesso (1, 2, 4 ... 64 ms);
+//  - tarefas registradas precisam dar sinal de vida (check-in) dentro do intervalo
+//    declarado;
+//  - um timer de supervisão alimenta o watchdog só enquanto todas as tarefas estão
+//    em dia e nenhuma fase passou do orçamento + DEADLINE_STALL_MARGIN_MS. No
+//    travamento ele para de alimentar e grava nos registradores de scratch do
+//    watchdog qual fase/tarefa travou; o relatório é impresso no boot seguinte.
+//
+// Fases podem ser aninhadas: o estouro aparece na fase mais interna (a causa) e
+// também nas externas. Despejos longos pela UART (trace, profiler) ficam entre
+// DEADLINE_PAUSE/DEADLINE_RESUME: o tempo pausado não conta contra fases nem tarefas,
+// e o watchdog só vence se a pausa passar de DEADLINE_PAUSE_MAX_MS. Compilado apenas com -DDEADLINE_MONITOR=ON no CMake;
+// caso contrário as macros somem.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef DEADLINE_WATCHDOG_MS
+#define DEADLINE_WATCHDOG_MS 2000 // reset após este tempo sem alimentar o watchdog
+#endif
+#ifndef DEADLINE_SUPERVISOR_MS
+#define DEADLINE_SUPERVISOR_MS 100 // período do timer de supervisão
+#endif
+#ifndef DEADLINE_STALL_MARGIN_MS
+#define DEADLINE_STALL_MARGIN_MS 1000 // além do orçamento, a fase é considerada travada
+#endif
+#ifndef DEADLINE_PAUSE_MAX_MS
+#define DEADLINE_PAUSE_MAX_MS 10000 // pausa mais longa que isto é travamento
+#endif
+#define DEADLINE_HIST_BUCKETS 8 // excesso < 1, 2, 4, 8, 16, 32, 64 ms e >= 64 ms
+
+typedef struct deadline_phase_t
+{
+    const char *nome;
+    uint32_t orcamento_us;
+    uint32_t execucoes;
+    uint32_t estouros;
+    uint32_t pior_us;
+    uint32_t hist[DEADLINE_HIST_BUCKETS];
+    uint32_t inicio_us;
+    struct deadline_phase_t *anterior; // fase ativa quando esta começou
+    struct deadline_phase_t *proxima;  // lista de fases já usadas (relatório)
+    bool registrada;
+} deadline_phase_t;
+
+typedef struct deadline_task_t
+{
+    const char *nome;
+    uint32_t intervalo_us; // prazo máximo entre dois check-ins
+    volatile uint32_t ultimo_us;
+    struct deadline_task_t *proxima;
+} deadline_task_t;
+
+#if DEADLINE_MONITOR
+
+void deadline_init(void);
+void deadline_begin(deadline_phase_t *f);
+void deadline_end(deadline_phase_t *f);
+void deadline_task_start(deadline_task_t *t);
+void deadline_checkin(deadline_task_t *t);
+void deadline_pause(void);
+void deadline_resume(void);
+void deadline_report(void);
+
+// Fase com orçamento fixo; BEGIN_BUDGET troca o orçamento para esta execução
+#define DEADLINE_PHASE(var, nome_fase, orcamento_ms) \
+    static deadline_phase_t var = {.nome = (nome_fase), .orcamento_us = (uint32_t)(orcamento_ms) * 1000u}
+#define DEADLINE_TASK(var, nome_tarefa, intervalo_ms) \
+    static deadline_task_t var = {.nome = (nome_tarefa), .intervalo_us = (uint32_t)(intervalo_ms) * 1000u}
+
+#define DEADLINE_INIT()                       deadline_init()
+#define DEADLINE_BEGIN(var)                   deadline_begin(&(var))
+#define DEADLINE_BEGIN_BUDGET(var, orcamento_ms) \
+    ((var).orcamento_us = (uint32_t)(orcamento_ms) * 1000u, deadline_begin(&(var)))
+#define DEADLINE_END(var)                     deadline_end(&(var))
+#define DEADLINE_TASK_START(var)              deadline_task_start(&(var))
+#define DEADLINE_CHECKIN(var)                 deadline_checkin(&(var))
+#define DEADLINE_PAUSE()                      deadline_pause()
+#define DEADLINE_RESUME()                     deadline_resume()
+#define DEADLINE_REPORT()                     deadline_report()
+
+#else
+
+#define DEADLINE_PHASE(var, nome, orcamento_ms)
+#define DEADLINE_TASK(var, nome, intervalo_ms)
+
+#define DEADLINE_INIT()                       ((void)0)
+#define DEADLINE_BEGIN(var)                   ((void)0)
+#define DEADLINE_BEGIN_BUDGET(var, orcamento_ms) ((void)0)
+#define DEADLINE_END(var)                     ((void)0)
+#define DEADLINE_TASK_START(var)              ((void)0)
+#define DEADLINE_CHECKIN(var)                 ((void)0)
+#define DEADLINE_PAUSE()                      ((void)0)
+#define DEADLINE_RESUME()                     ((void)0)
+#define DEADLINE_REPORT()                     ((void)0)
+
+#endif // DEADLINE_MONITOR
+
+#endif // DEADLINE_H
@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hardware/sync.h"
+#include "history.h"
+#include "http_stream.h"
+#include "hot_path.h"
+
+//------------- Acrescenta uma amostra, sobrescrevendo a mais antiga quando cheio
+void HOT_PATH(history_push)(history_t *h, const void *amostra)
+{
+    uint32_t irq = save_and_disable_interrupts(); // o servidor lê de dentro do lwIP
+    uint32_t i = h->proxima_seq % h->capacidade;
+    memcpy(h->dados + i * h->tam_amostra, amostra, h->tam_amostra);
+    h->proxima_seq++;
+    restore_interrupts(irq);
+}
+
+uint32_t history_oldest(const history_t *h)
+{
+    return h->proxima_seq > h->capacidade ? h->proxima_seq - h->capacidade : 0;
+}
+
+uint32_t history_next(const history_t *h)
+{
+    return h->proxima_seq;
+}
+
+//------------- Copia a amostra 'seq'; false se já foi sobrescrita ou ainda não existe
+bool history_get(const history_t *h, uint32_t seq, void *amostra)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    bool ok = seq >= history_oldest(h) && seq < h->proxima_seq;
+    if (ok)
+        memcpy(amostra, h->dados + (seq % h->capacidade) * h->tam_amostra, h->tam_amostra);
+    restore_interrupts(irq);
+    return ok;
+}
+
+void history_stream_init(history_stream_t *s, history_t *h, history_formatar_fn formatar,
+                         const char *cabecalho_csv, const char *alvo)
+{
+    char valor[12];
+    s->hist = h;
+    s->formatar = formatar;
+    s->seq = http_query_param(alvo, "since", valor, sizeof(valor)) ? (uint32_t)strtoul(valor, NULL, 10) : 0;
+    s->binario = http_query_param(alvo, "fmt", valor, sizeof(valor)) && strcmp(valor, "bin") == 0;
+    s->cabecalho_csv = s->binario ? NULL : cabecalho_csv;
+    // A resposta termina nas amostras existentes agora; as novas ficam para o próximo since
+    s->fim = history_next(h);
+}
+
+//------------- Gera o próximo pedaço do corpo: só registros inteiros
+size_t history_stream_gerar(void *estado, char *buf, size_t max, bool *fim)
+{
+    history_stream_t *s = estado;
+    size_t usado = 0;
+
+    if (s->cabecalho_csv)
+    {
+        size_t n = strlen(s->cabecalho_csv);
+        if (n > max)
+            return 0;
+        memcpy(buf, s->cabecalho_csv, n);
+        usado = n;
+        s->cabecalho_csv = NULL;
+    }
+
+    uint8_t amostra[64];
+    if (s->hist->tam_amostra > sizeof(amostra))
+    { // registro maior que o buffer local: só o cabeçalho
+        *fim = true;
+        return usado;
+    }
+    while (s->seq < s->fim)
+    {
+        uint32_t antiga = history_oldest(s->hist);
+        if (s->seq < antiga)
+            s->seq = antiga; // sobrescritas enquanto a resposta andava: pula
+        if (s->seq >= s->fim)
+            break;
+        if (!history_get(s->hist, s->seq, amostra))
+            continue; // sobrescrita entre as duas leituras: a próxima volta pula
+        size_t n = s->formatar(amostra, s->seq, s->binario, buf + usado, max - usado);
+        if (n == 0)
+            return usado; // não coube: vai no próximo chunk
+        usado += n;
+        s->seq++;
+    }
+    *fim = true;
+    return usado;
+}
@@ -0,0 +1,53 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+// Histórico de amostras em anel de tamanho fixo, com número de sequência global,
+// e o gerador que o serve por /history?since=<seq>&fmt=csv|bin via http_stream.
+//
+// O anel guarda registros de tamanho fixo definidos pela aplicação; o formato de
+// cada linha (CSV) ou registro (binário) também vem da aplicação.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct history_t
+{
+    uint8_t *dados;        // capacidade * tam_amostra bytes (estático na aplicação)
+    uint16_t tam_amostra;
+    uint16_t capacidade;
+    uint32_t proxima_seq;  // seq da próxima amostra; a mais antiga é proxima_seq - capacidade
+} history_t;
+
+// Escreve uma amostra (seq informado) como linha CSV ou registro binário em buf.
+// Devolve o número de bytes, ou 0 se não couber em max.
+typedef size_t (*history_formatar_fn)(const void *amostra, uint32_t seq, bool binario, char *buf, size_t max);
+
+#define HISTORY_DECLARE(nome, tipo, cap)               \
+    static tipo nome##_dados[cap];                     \
+    static history_t nome = {(uint8_t *)nome##_dados, sizeof(tipo), (cap), 0}
+
+void history_push(history_t *h, const void *amostra);
+uint32_t history_oldest(const history_t *h);
+uint32_t history_next(const history_t *h);
+bool history_get(const history_t *h, uint32_t seq, void *amostra);
+
+// Estado de uma resposta /history em andamento (cabe em HTTP_STREAM_ESTADO_MAX)
+typedef struct history_stream_t
+{
+    history_t *hist;
+    history_formatar_fn formatar;
+    const char *cabecalho_csv; // primeira linha do CSV (NULL = sem cabeçalho)
+    uint32_t seq;              // próxima amostra a enviar
+    uint32_t fim;              // amostras a partir desta ficam para o próximo pedido
+    bool binario;
+} history_stream_t;
+
+// Monta o estado a partir da query ("since", "fmt") do alvo do pedido
+void history_stream_init(history_stream_t *s, history_t *h, history_formatar_fn formatar,
+                         const char *cabecalho_csv, const char *alvo);
+
+// Gerador para http_stream_start
+size_t history_stream_gerar(void *estado, char *buf, size_t max, bool *fim);
+
+#endif // HISTORY_H
@@ -0,0 +1,21 @@
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+// Marcação de funções críticas em tempo (ISRs e tratadores chamados por elas) para
+// rodarem da SRAM em vez da flash via cache XIP: sem falta de cache quando o lwIP ou
+// o driver cyw43 expulsam o código, a latência de interrupção fica determinística.
+//
+//   void HOT_PATH(callback_botao)(uint gpio, uint32_t events) { ... }
+//
+// Com -DHOT_IN_RAM=OFF no CMake as funções voltam para a flash (para comparar com o
+// benchmark de isr_bench.h). tools/hot_report.py lista, depois do link, os símbolos de
+// hot_symbols.txt que ainda estão na flash e as chamadas que saem da RAM para a flash.
+
+#if HOT_IN_RAM
+#include "pico.h"
+#define HOT_PATH(nome) __not_in_flash_func(nome)
+#else
+#define HOT_PATH(nome) nome
+#endif
+
+#endif // HOT_PATH_H
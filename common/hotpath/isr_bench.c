@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/regs/m0plus.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "isr_bench.h"
+
+#define TRABALHO 16 // iterações do corpo do tratador
+
+typedef struct
+{
+    uint32_t min, max;
+    uint64_t soma;
+} medida_t;
+
+static volatile uint32_t t_entrada, t_saida;
+static volatile bool atendido;
+static volatile uint32_t acumulador;
+
+// Cópia na flash: noinline para o corpo ficar mesmo na XIP
+static void __attribute__((noinline)) tratador_flash(void)
+{
+    t_entrada = systick_hw->cvr;
+    for (int i = 0; i < TRABALHO; i++)
+        acumulador += i;
+    t_saida = systick_hw->cvr;
+    atendido = true;
+}
+
+static void __not_in_flash_func(tratador_ram)(void)
+{
+    t_entrada = systick_hw->cvr;
+    for (int i = 0; i < TRABALHO; i++)
+        acumulador += i;
+    t_saida = systick_hw->cvr;
+    atendido = true;
+}
+
+static void acumular(medida_t *m, uint32_t v)
+{
+    if (v < m->min)
+        m->min = v;
+    if (v > m->max)
+        m->max = v;
+    m->soma += v;
+}
+
+//------------- Dispara o IRQ várias vezes e mede (em RAM: só o tratador muda de lugar)
+static void __not_in_flash_func(medir)(uint irq, bool frio, medida_t *entrada, medida_t *duracao)
+{
+    *entrada = *duracao = (medida_t){UINT32_MAX, 0, 0};
+    for (int i = 0; i < ISR_BENCH_RODADAS; i++)
+    {
+        if (frio)
+        { // a leitura segura o barramento até o flush terminar
+            xip_ctrl_hw->flush = 1;
+            (void)xip_ctrl_hw->flush;
+        }
+        atendido = false;
+        // Com as interrupções mascaradas nenhum outro IRQ entra entre a marca e a pendência;
+        // ao desmascarar, o IRQ do benchmark (prioridade máxima) é atendido primeiro
+        uint32_t status = save_and_disable_interrupts();
+        uint32_t t0 = systick_hw->cvr;
+        *(io_rw_32 *)(PPB_BASE + M0PLUS_NVIC_ISPR_OFFSET) = 1u << irq;
+        restore_interrupts(status);
+        while (!atendido)
+            tight_loop_contents();
+        acumular(entrada, (t0 - t_entrada) & 0xffffffu); // SysTick conta para baixo
+        acumular(duracao, (t_entrada - t_saida) & 0xffffffu);
+    }
+}
+
+static void imprimir(const char *caso, const medida_t *e, const medida_t *d)
+{
+    printf("[ISR_BENCH] %-13s %4lu %6lu %5lu %7lu   %4lu %6lu %5lu %7lu\n", caso,
+           (unsigned long)e->min, (unsigned long)(e->soma / ISR_BENCH_RODADAS), (unsigned long)e->max,
+           (unsigned long)(e->max - e->min),
+           (unsigned long)d->min, (unsigned long)(d->soma / ISR_BENCH_RODADAS), (unsigned long)d->max,
+           (unsigned long)(d->max - d->min));
+}
+
+//------------- Mede os quatro casos (flash/RAM, cache quente/frio) e imprime a tabela
+void isr_bench_run(void)
+{
+    static const struct
+    {
+        const char *nome;
+        irq_handler_t tratador;
+        bool frio;
+    } casos[] = {
+        {"flash quente", tratador_flash, false},
+        {"flash fria", tratador_flash, true},
+        {"ram quente", tratador_ram, false},
+        {"ram fria", tratador_ram, true},
+    };
+
+    systick_hw->rvr = 0xffffffu;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    uint irq = (uint)user_irq_claim_unused(true);
+    irq_set_priority(irq, PICO_HIGHEST_IRQ_PRIORITY);
+    printf("[ISR_BENCH] %d disparos por caso, ciclos a %lu MHz\n", ISR_BENCH_RODADAS,
+           (unsigned long)(clock_get_hz(clk_sys) / 1000000));
+    printf("[ISR_BENCH] %-13s %4s %6s %5s %7s   %4s %6s %5s %7s\n", "caso",
+           "ent", "media", "max", "jitter", "dur", "media", "max", "jitter");
+    for (unsigned i = 0; i < sizeof(casos) / sizeof(casos[0]); i++)
+    {
+        medida_t entrada, duracao;
+        irq_set_exclusive_handler(irq, casos[i].tratador);
+        irq_set_enabled(irq, true);
+        medir(irq, casos[i].frio, &entrada, &duracao);
+        irq_set_enabled(irq, false);
+        irq_remove_handler(irq, casos[i].tratador);
+        imprimir(casos[i].nome, &entrada, &duracao);
+    }
+    user_irq_unclaim(irq);
+}
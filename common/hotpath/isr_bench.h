@@ -0,0 +1,31 @@
+#ifndef ISR_BENCH_H
+#define ISR_BENCH_H
+
+// Benchmark de latência de entrada e jitter de interrupção, com e sem posicionamento
+// na SRAM. O mesmo tratador existe em duas cópias (flash via XIP e SRAM) e é disparado
+// ISR_BENCH_RODADAS vezes por caso, marcando pendente um IRQ de usuário livre; os
+// tempos vêm do SysTick em ciclos de CPU:
+//  - entrada: da escrita no NVIC até a primeira instrução do tratador;
+//  - duração: corpo do tratador (um laço curto, como um callback de botão).
+// Os casos "frio" esvaziam o cache XIP antes de cada disparo, como acontece quando o
+// lwIP ou o cyw43 expulsam o tratador. O resultado sai pelo printf.
+//
+// Compilado apenas com -DISR_BENCH=ON no CMake; caso contrário a macro some.
+
+#ifndef ISR_BENCH_RODADAS
+#define ISR_BENCH_RODADAS 1000
+#endif
+
+#if ISR_BENCH
+
+void isr_bench_run(void);
+
+#define ISR_BENCH_RUN() isr_bench_run()
+
+#else
+
+#define ISR_BENCH_RUN() ((void)0)
+
+#endif // ISR_BENCH
+
+#endif // ISR_BENCH_H
@@ -0,0 +1,149 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "http_cache.h"
+
+typedef struct http_cache_buf_t
+{
+    uint32_t geracao;
+    uint16_t len;
+    uint8_t refs;  // conexões com bytes deste buffer ainda não confirmados
+    bool em_cache; // é o 'atual' de alguma página
+    char dados[HTTP_CACHE_BUF_MAX];
+} http_cache_buf_t;
+
+typedef struct
+{
+    struct tcp_pcb *pcb;
+    http_cache_buf_t *buf;
+    uint32_t pendentes; // bytes escritos ainda sem tcp_sent
+} envio_t;
+
+static http_cache_buf_t bufs[HTTP_CACHE_BUFS];
+static envio_t envios[HTTP_CACHE_MAX_CONEXOES];
+
+static void soltar(envio_t *e)
+{
+    e->buf->refs--;
+    e->buf = NULL;
+    e->pcb = NULL;
+}
+
+static err_t ao_enviar(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    envio_t *e = arg;
+    if (!e || !e->buf)
+        return ERR_OK;
+    e->pendentes = len < e->pendentes ? e->pendentes - len : 0;
+    if (e->pendentes > 0)
+        return ERR_OK;
+
+    // O cliente já tem tudo: o lwIP não referencia mais o buffer e a resposta
+    // ("Connection: close") termina aqui
+    tcp_arg(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    soltar(e);
+    if (tcp_close(pcb) != ERR_OK)
+    {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+// Pedidos seguintes na mesma conexão (keep-alive) chegam antes da confirmação: são
+// descartados, para nenhum outro módulo trocar os callbacks do pcb com o buffer preso
+static err_t ao_receber(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    (void)arg;
+    (void)err;
+    if (p)
+    {
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+    }
+    return ERR_OK; // cliente fechou: o fechamento vem com a confirmação em ao_enviar
+}
+
+static void ao_erro(void *arg, err_t err)
+{
+    (void)err;
+    envio_t *e = arg;
+    if (e && e->buf) // o lwIP já liberou o pcb e os pbufs que apontavam para o buffer
+        soltar(e);
+}
+
+//------------- Buffer com a geração pedida: o atual, um livre re-renderizado ou o antigo.
+// 'contador' aponta a estatística do caso, somada só depois que o envio der certo.
+static http_cache_buf_t *obter(http_cache_t *c, uint32_t geracao, uint32_t **contador)
+{
+    http_cache_buf_t *b = c->atual;
+    if (b && b->geracao == geracao)
+    {
+        *contador = &c->acertos;
+        return b;
+    }
+    if (!b || b->refs > 0)
+    {
+        b = NULL;
+        for (int i = 0; i < HTTP_CACHE_BUFS && !b; i++)
+            if (!bufs[i].em_cache && bufs[i].refs == 0)
+                b = &bufs[i];
+    }
+    if (!b)
+    { // todos presos em conexões lentas
+        *contador = &c->antigas;
+        return c->atual;
+    }
+
+    size_t n = c->render(b->dados, sizeof(b->dados));
+    if (n == 0 || n > sizeof(b->dados))
+        return NULL;
+    *contador = &c->falhas;
+    if (c->atual)
+        c->atual->em_cache = false;
+    b->em_cache = true;
+    b->geracao = geracao;
+    b->len = (uint16_t)n;
+    c->atual = b;
+    return b;
+}
+
+err_t http_cache_send(http_cache_t *c, struct tcp_pcb *pcb, uint32_t geracao)
+{
+    envio_t *e = NULL;
+    for (int i = 0; i < HTTP_CACHE_MAX_CONEXOES && !e; i++)
+        if (!envios[i].buf)
+            e = &envios[i];
+    uint32_t *contador = NULL;
+    http_cache_buf_t *b = e ? obter(c, geracao, &contador) : NULL;
+    if (!b || tcp_write(pcb, b->dados, b->len, 0) != ERR_OK)
+    {
+        c->recusadas++;
+        return ERR_MEM;
+    }
+
+    // A conexão fica com o cache até a confirmação: o envio só é solto em ao_enviar
+    // ou ao_erro, que nenhum outro módulo pode trocar antes disso
+    e->pcb = pcb;
+    e->buf = b;
+    e->pendentes = b->len;
+    b->refs++;
+    tcp_arg(pcb, e);
+    tcp_sent(pcb, ao_enviar);
+    tcp_recv(pcb, ao_receber);
+    tcp_err(pcb, ao_erro);
+    (*contador)++;
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+void http_cache_report(const http_cache_t *c)
+{
+    uint32_t pedidos = c->acertos + c->falhas + c->antigas;
+    printf("[HTTP_CACHE] %s: pedidos=%lu acertos=%lu renderizacoes=%lu antigas=%lu recusadas=%lu (%lu%% sem renderizar)\n",
+           c->nome, (unsigned long)pedidos, (unsigned long)c->acertos, (unsigned long)c->falhas,
+           (unsigned long)c->antigas, (unsigned long)c->recusadas,
+           (unsigned long)(pedidos ? 100u * (pedidos - c->falhas) / pedidos : 0));
+}
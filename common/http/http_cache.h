@@ -0,0 +1,64 @@
+#ifndef HTTP_CACHE_H
+#define HTTP_CACHE_H
+
+// Resposta HTTP renderizada uma vez e compartilhada por todos os clientes enquanto o
+// estado exibido não muda. A aplicação mantém um contador de geração que avança a cada
+// mudança do que a página mostra; pedidos na mesma geração reaproveitam o buffer já
+// pronto. O buffer vai para cada conexão por tcp_write sem cópia (pbufs de referência
+// do lwIP) e tem contagem de referências: só volta ao pool depois do último tcp_sent
+// que confirma os bytes dele (ou do erro que derruba a conexão). N clientes custam
+// uma renderização e N envios.
+//
+// Se todos os buffers estão presos em conexões lentas e a geração mudou, o buffer
+// atual (da geração anterior) é servido de novo em vez de recusar o pedido.
+//
+// A resposta renderizada deve ter "Connection: close": depois do http_cache_send a
+// conexão é do cache, que descarta pedidos seguintes nela e a fecha quando o último
+// byte for confirmado. Assim nenhum outro módulo (http_stream) troca os callbacks do
+// pcb enquanto o buffer ainda está referenciado.
+// Para o envio sem cópia valer de fato, o lwipopts.h não pode ter LWIP_NETIF_TX_SINGLE_PBUF,
+// que força a cópia dentro do tcp_write.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "lwip/tcp.h"
+
+#ifndef HTTP_CACHE_BUFS
+#define HTTP_CACHE_BUFS 2 // buffers compartilhados por todas as páginas
+#endif
+#ifndef HTTP_CACHE_BUF_MAX
+#define HTTP_CACHE_BUF_MAX 1536 // resposta completa, com cabeçalho
+#endif
+#ifndef HTTP_CACHE_MAX_CONEXOES
+#define HTTP_CACHE_MAX_CONEXOES 4 // conexões com envio ainda não confirmado
+#endif
+
+// Renderiza a resposta completa (cabeçalho e corpo) em buf. Devolve o tamanho, ou 0
+// se não coube em 'max'.
+typedef size_t (*http_cache_render_fn)(char *buf, size_t max);
+
+struct http_cache_buf_t;
+
+typedef struct http_cache_t
+{
+    const char *nome;
+    http_cache_render_fn render;
+    struct http_cache_buf_t *atual; // última renderização
+    uint32_t acertos;               // pedidos servidos sem renderizar
+    uint32_t falhas;                // pedidos servidos com uma renderização nova
+    uint32_t antigas;               // geração anterior servida por falta de buffer
+    uint32_t recusadas;             // sem conexão livre ou tcp_write falhou
+} http_cache_t;
+
+#define HTTP_CACHE_DECLARE(var, nome, render) http_cache_t var = {nome, render, NULL, 0, 0, 0, 0}
+
+// Envia a resposta da geração 'geracao' em pcb, renderizando só se ela mudou, e fecha
+// a conexão depois da confirmação. Chamar num callback do lwIP. Retorna ERR_OK ou
+// ERR_MEM (nada foi enviado e a conexão continua da aplicação, que decide, por exemplo
+// com http_stream_busy).
+err_t http_cache_send(http_cache_t *c, struct tcp_pcb *pcb, uint32_t geracao);
+
+// Imprime acertos, renderizações e taxa de acerto
+void http_cache_report(const http_cache_t *c);
+
+#endif // HTTP_CACHE_H
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include "http_server.h"
+#include "http_stream.h"
+#include "lwip/pbuf.h"
+
+static http_route_t *rotas;
+
+void http_server_route(http_route_t *r)
+{
+    r->proxima = NULL;
+    http_route_t **p = &rotas;
+    while (*p)
+        p = &(*p)->proxima;
+    *p = r;
+}
+
+static err_t nao_encontrado(struct tcp_pcb *pcb)
+{
+    static const char resposta[] = "HTTP/1.1 404 Not Found\r\n"
+                                   "Content-Length: 0\r\n"
+                                   "Connection: close\r\n\r\n";
+    tcp_write(pcb, resposta, sizeof(resposta) - 1, 0); // constante em flash: sem cópia
+    tcp_output(pcb);
+    if (tcp_close(pcb) != ERR_OK)
+    {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+//------------- Pedido recebido: consome e despacha para a rota do caminho
+static err_t receber_pedido(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    (void)arg;
+    (void)err;
+    if (!p)
+    {
+        tcp_close(pcb);
+        tcp_recv(pcb, NULL);
+        return ERR_OK;
+    }
+
+    char alvo[64];
+    bool get = http_request_target(p, alvo, sizeof(alvo));
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    if (get)
+        for (http_route_t *r = rotas; r; r = r->proxima)
+            if (http_path_is(alvo, r->caminho))
+                return r->tratar(pcb, alvo);
+    return nao_encontrado(pcb);
+}
+
+static err_t ao_aceitar(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    (void)arg;
+    (void)err;
+    tcp_recv(pcb, receber_pedido);
+    return ERR_OK;
+}
+
+bool http_server_start(uint16_t porta)
+{
+    struct tcp_pcb *pcb = tcp_new();
+    if (!pcb)
+    {
+        printf("Falha ao criar servidor TCP\n");
+        return false;
+    }
+    if (tcp_bind(pcb, IP_ANY_TYPE, porta) != ERR_OK)
+    {
+        printf("Falha ao associar servidor TCP à porta %u\n", porta);
+        return false;
+    }
+    struct tcp_pcb *escuta = tcp_listen(pcb);
+    if (!escuta)
+    {
+        printf("Falha ao escutar na porta %u\n", porta);
+        return false;
+    }
+    tcp_accept(escuta, ao_aceitar);
+    printf("Servidor web iniciado na porta %u\n", porta);
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+// Servidor HTTP único sobre a API raw TCP do lwIP: o esqueleto de accept/recv que
+// cada servidor web repetia, com uma tabela de rotas preenchida pelos módulos.
+// O pedido é consumido (tcp_recved + pbuf_free) antes de chamar a rota, que só
+// responde: por http_stream, http_cache ou um tcp_write próprio. Caminho sem rota
+// recebe 404.
+//
+//   static err_t servir_history(struct tcp_pcb *pcb, const char *alvo);
+//   HTTP_ROUTE(rota_history, "/history", servir_history);
+//   http_server_route(&rota_history);
+//   http_server_start(80);
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lwip/tcp.h"
+
+// Responde ao pedido em pcb ('alvo' inclui a query string). Devolve o err_t do
+// callback do lwIP: ERR_ABRT se a rota abortou a conexão.
+typedef err_t (*http_route_fn)(struct tcp_pcb *pcb, const char *alvo);
+
+typedef struct http_route_t
+{
+    const char *caminho; // casa sem a query: "/history" atende "/history?since=3"
+    http_route_fn tratar;
+    struct http_route_t *proxima;
+} http_route_t;
+
+#define HTTP_ROUTE(var, caminho_rota, tratador) \
+    static http_route_t var = {.caminho = (caminho_rota), .tratar = (tratador)}
+
+// Acrescenta uma rota; a primeira registrada para um caminho vence
+void http_server_route(http_route_t *r);
+
+// Escuta na porta. Retorna false se não conseguiu criar, associar ou escutar.
+bool http_server_start(uint16_t porta);
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <string.h>
+#include "http_stream.h"
+
+#define CAB_CHUNK       5  // "xxx\r\n": tamanho com 3 dígitos hex fixos
+#define ULTIMO_CHUNK    "0\r\n\r\n"
+#define TAM_ULTIMO      5
+#define ESPACO_MINIMO   64 // não vale a pena gerar chunks menores que isto
+#define POLL_INTERVALO  2  // tcp_poll a cada ~1 s tenta de novo se o envio travou
+
+_Static_assert(HTTP_STREAM_CHUNK_MAX <= 0xfff, "HTTP_STREAM_CHUNK_MAX não cabe nos 3 dígitos hex do cabeçalho do chunk");
+
+typedef struct
+{
+    struct tcp_pcb *pcb;
+    http_stream_gerador_fn gerador;
+    uint8_t estado[HTTP_STREAM_ESTADO_MAX];
+    bool em_uso;
+} conexao_t;
+
+static conexao_t conexoes[HTTP_STREAM_MAX_CONEXOES];
+
+// Área de montagem compartilhada: tcp_write copia os dados na hora e os callbacks
+// do lwIP nunca rodam em paralelo, então um único buffer basta para todas as conexões.
+static char chunk[CAB_CHUNK + HTTP_STREAM_CHUNK_MAX + 2 + TAM_ULTIMO];
+
+static void soltar_callbacks(struct tcp_pcb *pcb)
+{
+    tcp_arg(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+}
+
+static err_t encerrar(conexao_t *c, bool abortar)
+{
+    struct tcp_pcb *pcb = c->pcb;
+    c->em_uso = false;
+    c->pcb = NULL;
+    soltar_callbacks(pcb);
+    if (!abortar && tcp_close(pcb) == ERR_OK)
+        return ERR_OK;
+    tcp_abort(pcb);
+    return ERR_ABRT;
+}
+
+// Gera e enfileira chunks enquanto houver espaço no buffer de envio
+static err_t bombear(conexao_t *c)
+{
+    struct tcp_pcb *pcb = c->pcb;
+    while (tcp_sndbuf(pcb) >= ESPACO_MINIMO)
+    {
+        // Reserva espaço para o último chunk: o gerador pode acabar nesta chamada
+        size_t max = tcp_sndbuf(pcb) - CAB_CHUNK - 2 - TAM_ULTIMO;
+        if (max > HTTP_STREAM_CHUNK_MAX)
+            max = HTTP_STREAM_CHUNK_MAX;
+
+        uint8_t anterior[HTTP_STREAM_ESTADO_MAX];
+        memcpy(anterior, c->estado, sizeof(anterior));
+        bool fim = false;
+        size_t n = c->gerador(c->estado, chunk + CAB_CHUNK, max, &fim);
+        if (n == 0 && !fim)
+        { // o próximo registro não coube: espera o buffer esvaziar, a menos que já esteja vazio
+            if (max == HTTP_STREAM_CHUNK_MAX || tcp_sndbuf(pcb) == TCP_SND_BUF)
+                return encerrar(c, true); // registro maior que um chunk: nunca vai caber
+            break;
+        }
+
+        size_t len = 0;
+        if (n > 0)
+        {
+            static const char hex[] = "0123456789abcdef";
+            chunk[0] = hex[(n >> 8) & 0xf];
+            chunk[1] = hex[(n >> 4) & 0xf];
+            chunk[2] = hex[n & 0xf];
+            chunk[3] = '\r';
+            chunk[4] = '\n';
+            chunk[CAB_CHUNK + n] = '\r';
+            chunk[CAB_CHUNK + n + 1] = '\n';
+            len = CAB_CHUNK + n + 2;
+        }
+        if (fim)
+        {
+            memcpy(chunk + len, ULTIMO_CHUNK, TAM_ULTIMO);
+            len += TAM_ULTIMO;
+        }
+
+        err_t err = tcp_write(pcb, chunk, (u16_t)len, TCP_WRITE_FLAG_COPY);
+        if (err == ERR_MEM)
+        { // fila cheia: desfaz o avanço do gerador e continua no próximo tcp_sent/tcp_poll
+            memcpy(c->estado, anterior, sizeof(anterior));
+            break;
+        }
+        if (err != ERR_OK)
+            return encerrar(c, true);
+        if (fim)
+        {
+            tcp_output(pcb);
+            return encerrar(c, false); // o lwIP termina de enviar o que está na fila e manda FIN
+        }
+    }
+    tcp_output(pcb);
+    return ERR_OK;
+}
+
+static err_t ao_enviar(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    (void)pcb;
+    (void)len;
+    return arg ? bombear((conexao_t *)arg) : ERR_OK;
+}
+
+static err_t ao_consultar(void *arg, struct tcp_pcb *pcb)
+{
+    (void)pcb;
+    return arg ? bombear((conexao_t *)arg) : ERR_OK;
+}
+
+static err_t ao_receber(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    (void)err;
+    if (p)
+    { // o cliente não tem mais nada a pedir nesta conexão; só descarta
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+        return ERR_OK;
+    }
+    return arg ? encerrar((conexao_t *)arg, false) : ERR_OK; // cliente fechou no meio
+}
+
+static void ao_erro(void *arg, err_t err)
+{
+    (void)err;
+    conexao_t *c = arg;
+    if (c)
+    { // o lwIP já liberou o pcb
+        c->em_uso = false;
+        c->pcb = NULL;
+    }
+}
+
+err_t http_stream_start(struct tcp_pcb *pcb, const char *content_type, const char *cabecalhos_extra,
+                        http_stream_gerador_fn gerador, const void *estado, size_t tam_estado)
+{
+    conexao_t *c = NULL;
+    for (int i = 0; i < HTTP_STREAM_MAX_CONEXOES && !c; i++)
+        if (!conexoes[i].em_uso)
+            c = &conexoes[i];
+    if (!c || tam_estado > HTTP_STREAM_ESTADO_MAX)
+        return ERR_MEM;
+
+    int n = snprintf(chunk, sizeof(chunk),
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: %s\r\n"
+                     "Transfer-Encoding: chunked\r\n"
+                     "Cache-Control: no-store\r\n"
+                     "Connection: close\r\n"
+                     "%s\r\n",
+                     content_type, cabecalhos_extra ? cabecalhos_extra : "");
+    if (n < 0 || (size_t)n >= sizeof(chunk) || tcp_write(pcb, chunk, (u16_t)n, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        return ERR_MEM;
+
+    c->em_uso = true;
+    c->pcb = pcb;
+    c->gerador = gerador;
+    memset(c->estado, 0, sizeof(c->estado));
+    memcpy(c->estado, estado, tam_estado);
+
+    tcp_arg(pcb, c);
+    tcp_sent(pcb, ao_enviar);
+    tcp_recv(pcb, ao_receber);
+    tcp_err(pcb, ao_erro);
+    tcp_poll(pcb, ao_consultar, POLL_INTERVALO);
+    return bombear(c);
+}
+
+err_t http_stream_busy(struct tcp_pcb *pcb)
+{
+    static const char resposta[] = "HTTP/1.1 503 Service Unavailable\r\n"
+                                   "Retry-After: 1\r\n"
+                                   "Content-Length: 0\r\n"
+                                   "Connection: close\r\n\r\n";
+    tcp_write(pcb, resposta, sizeof(resposta) - 1, 0); // constante em flash: sem cópia
+    tcp_output(pcb);
+    if (tcp_close(pcb) != ERR_OK)
+    {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+bool http_request_target(const struct pbuf *p, char *alvo, size_t max)
+{
+    char linha[128];
+    u16_t n = pbuf_copy_partial(p, linha, sizeof(linha) - 1, 0);
+    linha[n] = '\0';
+    if (strncmp(linha, "GET ", 4) != 0 || max == 0)
+        return false;
+    size_t i = 0;
+    for (const char *s = linha + 4; *s && *s != ' ' && *s != '\r' && *s != '\n' && i < max - 1; s++)
+        alvo[i++] = *s;
+    alvo[i] = '\0';
+    return i > 0;
+}
+
+bool http_path_is(const char *alvo, const char *caminho)
+{
+    size_t n = strlen(caminho);
+    return strncmp(alvo, caminho, n) == 0 && (alvo[n] == '\0' || alvo[n] == '?');
+}
+
+bool http_query_param(const char *alvo, const char *nome, char *valor, size_t max)
+{
+    const char *s = strchr(alvo, '?');
+    size_t n = strlen(nome);
+    while (s && *s)
+    {
+        s++; // pula '?' ou '&'
+        if (strncmp(s, nome, n) == 0 && s[n] == '=')
+        {
+            s += n + 1;
+            size_t i = 0;
+            while (*s && *s != '&' && i < max - 1)
+                valor[i++] = *s++;
+            valor[i] = '\0';
+            return true;
+        }
+        s = strchr(s, '&');
+    }
+    return false;
+}
@@ -0,0 +1,51 @@
+#ifndef HTTP_STREAM_H
+#define HTTP_STREAM_H
+
+// Respostas HTTP em "Transfer-Encoding: chunked" geradas sob demanda sobre a API raw
+// TCP do lwIP: cada chunk é produzido por um gerador da aplicação só quando há espaço
+// no buffer de envio (tcp_sndbuf), e a geração continua no callback tcp_sent.
+// A resposta inteira nunca existe na memória; as conexões vêm de um pool estático.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lwip/tcp.h"
+
+#ifndef HTTP_STREAM_MAX_CONEXOES
+#define HTTP_STREAM_MAX_CONEXOES 4
+#endif
+#ifndef HTTP_STREAM_ESTADO_MAX
+#define HTTP_STREAM_ESTADO_MAX 48 // bytes de estado do gerador por conexão
+#endif
+#ifndef HTTP_STREAM_CHUNK_MAX
+#define HTTP_STREAM_CHUNK_MAX 1024 // dados por chunk (até 0xfff: tamanho em 3 dígitos hex)
+#endif
+
+// Gerador: escreve até 'max' bytes do corpo em buf e devolve quantos escreveu; marca
+// *fim quando o corpo acabou (o último chunk vai junto com estes bytes). Devolver 0
+// sem *fim significa que o próximo registro não coube: o gerador é chamado de novo
+// quando houver mais espaço. O estado é restaurado se o envio falhar, então o
+// gerador só deve alterar o próprio estado.
+typedef size_t (*http_stream_gerador_fn)(void *estado, char *buf, size_t max, bool *fim);
+
+// Começa a responder em pcb. 'estado' (até HTTP_STREAM_ESTADO_MAX bytes) é copiado
+// para a conexão. 'cabecalhos_extra' pode ser NULL ou linhas terminadas em "\r\n".
+// Retorna ERR_OK; ERR_MEM se não houver conexão livre ou espaço para o cabeçalho
+// (nada foi enviado, a aplicação decide o que fazer); ou ERR_ABRT se a conexão foi
+// abortada, caso em que o callback do lwIP que chamou deve devolver ERR_ABRT.
+err_t http_stream_start(struct tcp_pcb *pcb, const char *content_type, const char *cabecalhos_extra,
+                        http_stream_gerador_fn gerador, const void *estado, size_t tam_estado);
+
+// Responde "503 Service Unavailable" e fecha (pool de conexões esgotado)
+err_t http_stream_busy(struct tcp_pcb *pcb);
+
+// Extrai o alvo da linha "GET <alvo> HTTP/1.1" do pedido. Retorna false se não for GET.
+bool http_request_target(const struct pbuf *p, char *alvo, size_t max);
+
+// Caminho sem a query string: "/history?since=3" casa com "/history"
+bool http_path_is(const char *alvo, const char *caminho);
+
+// Valor de um parâmetro da query string ("since" em "/history?since=3&fmt=csv")
+bool http_query_param(const char *alvo, const char *nome, char *valor, size_t max);
+
+#endif // HTTP_STREAM_H
@@ -0,0 +1,20 @@
+# Perfil de ajuste do lwIP compartilhado pelos projetos (common/lwip/lwipopts.h).
+# Uso: include(.../common/lwip/lwip_profile.cmake) e lwip_profile_apply(<alvo>)
+
+set(LWIP_PROFILE_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(LWIP_PROFILES generic low_memory many_small_connections streaming_throughput)
+set(LWIP_PROFILE generic CACHE STRING "Perfil do lwIP: ${LWIP_PROFILES}")
+set_property(CACHE LWIP_PROFILE PROPERTY STRINGS ${LWIP_PROFILES})
+if (NOT LWIP_PROFILE IN_LIST LWIP_PROFILES)
+    message(FATAL_ERROR "LWIP_PROFILE=${LWIP_PROFILE} desconhecido; use um de: ${LWIP_PROFILES}")
+endif()
+option(LWIP_DEBUG_ON "Mensagens de depuração do lwIP (LWIP_DEBUG)" OFF)
+
+function(lwip_profile_apply target)
+    string(TOUPPER ${LWIP_PROFILE} perfil)
+    target_include_directories(${target} PUBLIC ${LWIP_PROFILE_DIR})
+    target_compile_definitions(${target} PUBLIC LWIP_PROFILE_${perfil}=1)
+    if (LWIP_DEBUG_ON)
+        target_compile_definitions(${target} PUBLIC LWIP_DEBUG_ON=1)
+    endif()
+endfunction()
@@ -0,0 +1,178 @@
+#ifndef __LWIPOPTS_H__
+#define __LWIPOPTS_H__
+
+// Configuração do lwIP compartilhada pelos servidores web (e pelo semáforo com
+// -DTIME_SYNC=NTP), com perfis de ajuste escolhidos no CMake (-DLWIP_PROFILE=...,
+// ver lwip_profile.cmake):
+//   generic                 valores genéricos dos exemplos da pico_w (padrão)
+//   low_memory              janela e buffers mínimos, poucas conexões
+//   many_small_connections  muitos painéis pedindo páginas pequenas ao mesmo tempo
+//   streaming_throughput    respostas longas (/history) com a maior vazão por conexão
+// Os perfis também dimensionam os pools de http_stream e http_cache, que leem estes
+// valores antes dos próprios padrões. tools/lwip_bench.py compara os perfis no host.
+// LWIP_DEBUG fica desligado em todos os perfis, a menos que -DLWIP_DEBUG_ON=ON.
+// (see https://www.nongnu.org/lwip/2_1_x/group__lwip__opts.html for details)
+
+// allow override in some examples
+#ifndef NO_SYS
+#define NO_SYS                      1
+#endif
+// allow override in some examples
+#ifndef LWIP_SOCKET
+#define LWIP_SOCKET                 0
+#endif
+#if PICO_CYW43_ARCH_POLL && !STATIC_ALLOC
+#define MEM_LIBC_MALLOC             1
+#else
+// MEM_LIBC_MALLOC is incompatible with non polling versions
+// (e no modo STATIC_ALLOC o heap do lwIP é sempre o vetor estático de MEM_SIZE)
+#define MEM_LIBC_MALLOC             0
+#endif
+#define MEMP_MEM_MALLOC             0
+#define MEM_ALIGNMENT               4
+#define TCP_MSS                     1460
+
+#if LWIP_PROFILE_LOW_MEMORY
+// Heap só para os chunks copiados de uma ou duas respostas; a janela de 2 MSS cabe
+// em 6 buffers do pool de recepção (~9 KB em vez de ~37 KB)
+#define LWIP_PROFILE_NAME           "low_memory"
+#define MEM_SIZE                    2048
+#define PBUF_POOL_SIZE              6
+#define MEMP_NUM_TCP_PCB            3
+#define MEMP_NUM_TCP_SEG            8
+#define MEMP_NUM_PBUF               8
+#define MEMP_NUM_ARP_QUEUE          4
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+#define HTTP_STREAM_MAX_CONEXOES    2
+#define HTTP_STREAM_CHUNK_MAX       512
+#define HTTP_CACHE_MAX_CONEXOES     2
+
+#elif LWIP_PROFILE_MANY_SMALL_CONNECTIONS
+// Respostas de ~1 KB: buffer de envio pequeno por conexão e heap dividido entre
+// muitas; mais pcbs e pbufs de referência para o envio sem cópia do http_cache
+#define LWIP_PROFILE_NAME           "many_small_connections"
+#define MEM_SIZE                    12000
+#define PBUF_POOL_SIZE              16
+#define MEMP_NUM_TCP_PCB            12
+#define MEMP_NUM_TCP_SEG            32
+#define MEMP_NUM_PBUF               24
+#define MEMP_NUM_ARP_QUEUE          10
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+#define HTTP_CACHE_MAX_CONEXOES     12
+#define HTTP_CACHE_BUFS             3
+
+#elif LWIP_PROFILE_STREAMING_THROUGHPUT
+// Vazão de uma conexão longa ~ TCP_SND_BUF / RTT: buffer de envio grande, com heap
+// para mantê-lo cheio de chunks copiados, e chunks maiores (menos cabeçalhos)
+#define LWIP_PROFILE_NAME           "streaming_throughput"
+#define MEM_SIZE                    20000
+#define PBUF_POOL_SIZE              24
+#define MEMP_NUM_TCP_PCB            5
+#define MEMP_NUM_TCP_SEG            48
+#define MEMP_NUM_PBUF               16
+#define MEMP_NUM_ARP_QUEUE          10
+#define TCP_WND                     (8 * TCP_MSS)
+#define TCP_SND_BUF                 (10 * TCP_MSS)
+#define HTTP_STREAM_CHUNK_MAX       2048
+
+#else
+// Common settings used in most of the pico_w examples
+#define LWIP_PROFILE_NAME           "generic"
+#define MEM_SIZE                    4000
+#define PBUF_POOL_SIZE              24
+#define MEMP_NUM_TCP_PCB            5
+#define MEMP_NUM_TCP_SEG            32
+#define MEMP_NUM_PBUF               16
+#define MEMP_NUM_ARP_QUEUE          10
+#define TCP_WND                     (8 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
+#endif
+
+#define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#define LWIP_ARP                    1
+#define LWIP_ETHERNET               1
+#define LWIP_ICMP                   1
+#define LWIP_RAW                    1
+#define LWIP_NETIF_STATUS_CALLBACK  1
+#define LWIP_NETIF_LINK_CALLBACK    1
+#define LWIP_NETIF_HOSTNAME         1
+#define LWIP_NETCONN                0
+#if STATIC_ALLOC
+// Marcas d'água do heap e dos pools para o relatório de mem_stats.c
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#else
+#define MEM_STATS                   0
+#define MEMP_STATS                  0
+#endif
+#define SYS_STATS                   0
+#define LINK_STATS                  0
+// #define ETH_PAD_SIZE                2
+#define LWIP_CHKSUM_ALGORITHM       3
+#define LWIP_DHCP                   1
+#define LWIP_IPV4                   1
+#define LWIP_TCP                    1
+#define LWIP_UDP                    1
+#define LWIP_DNS                    1
+#define LWIP_TCP_KEEPALIVE          1
+#define LWIP_NETIF_TX_SINGLE_PBUF   0 // 1 força cópia no tcp_write e anula o http_cache sem cópia
+#define DHCP_DOES_ARP_CHECK         0
+#define LWIP_DHCP_DOES_ACD_CHECK    0
+
+#if TIMESYNC_NTP
+// Fonte NTP do common/timesync: hora entregue e lida pelo timesync_ntp.c
+#include <stdint.h>
+#ifndef TIMESYNC_PERIODO_S
+#define TIMESYNC_PERIODO_S          60 // mesmo padrão de timesync.h
+#endif
+void timesync_ntp_set(uint32_t seg, uint32_t us);
+void timesync_ntp_get(uint32_t *seg, uint32_t *us);
+#define SNTP_SERVER_DNS             1
+#define SNTP_COMP_ROUNDTRIP         1
+#define SNTP_UPDATE_DELAY           (TIMESYNC_PERIODO_S * 1000) // mínimo de 15 s no lwIP
+#define SNTP_SET_SYSTEM_TIME_US(seg, us) timesync_ntp_set((seg), (us))
+#define SNTP_GET_SYSTEM_TIME(seg, us) timesync_ntp_get(&(seg), &(us))
+#define MEMP_NUM_SYS_TIMEOUT        (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 1) // timer do SNTP
+#endif
+
+// Depuração só quando pedida (-DLWIP_DEBUG_ON=ON): também custa tempo e flash em Debug
+#if LWIP_DEBUG_ON
+#define LWIP_DEBUG                  1
+#endif
+#if !defined(NDEBUG) || STATIC_ALLOC
+#define LWIP_STATS                  1
+#define LWIP_STATS_DISPLAY          1
+#endif
+
+#define ETHARP_DEBUG                LWIP_DBG_OFF
+#define NETIF_DEBUG                 LWIP_DBG_OFF
+#define PBUF_DEBUG                  LWIP_DBG_OFF
+#define API_LIB_DEBUG               LWIP_DBG_OFF
+#define API_MSG_DEBUG               LWIP_DBG_OFF
+#define SOCKETS_DEBUG               LWIP_DBG_OFF
+#define ICMP_DEBUG                  LWIP_DBG_OFF
+#define INET_DEBUG                  LWIP_DBG_OFF
+#define IP_DEBUG                    LWIP_DBG_OFF
+#define IP_REASS_DEBUG              LWIP_DBG_OFF
+#define RAW_DEBUG                   LWIP_DBG_OFF
+#define MEM_DEBUG                   LWIP_DBG_OFF
+#define MEMP_DEBUG                  LWIP_DBG_OFF
+#define SYS_DEBUG                   LWIP_DBG_OFF
+#define TCP_DEBUG                   LWIP_DBG_OFF
+#define TCP_INPUT_DEBUG             LWIP_DBG_OFF
+#define TCP_OUTPUT_DEBUG            LWIP_DBG_OFF
+#define TCP_RTO_DEBUG               LWIP_DBG_OFF
+#define TCP_CWND_DEBUG              LWIP_DBG_OFF
+#define TCP_WND_DEBUG               LWIP_DBG_OFF
+#define TCP_FR_DEBUG                LWIP_DBG_OFF
+#define TCP_QLEN_DEBUG              LWIP_DBG_OFF
+#define TCP_RST_DEBUG               LWIP_DBG_OFF
+#define UDP_DEBUG                   LWIP_DBG_OFF
+#define TCPIP_DEBUG                 LWIP_DBG_OFF
+#define PPP_DEBUG                   LWIP_DBG_OFF
+#define SLIP_DEBUG                  LWIP_DBG_OFF
+#define DHCP_DEBUG                  LWIP_DBG_OFF
+
+#endif /* __LWIPOPTS_H__ */
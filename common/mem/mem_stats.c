@@ -0,0 +1,67 @@
+#include <malloc.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "mem_stats.h"
+
+#if MEM_STATS_LWIP
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#endif
+
+#define PADRAO_PILHA 0xC0FFEE42u
+#define MARGEM_SP    64 // bytes abaixo do SP atual que não são pintados (quadro de mem_stats_init)
+
+// Regiões de pilha definidas pelo script de link do SDK (memmap_default.ld)
+extern uint32_t __StackBottom, __StackTop;       // núcleo 0, SCRATCH_Y
+extern uint32_t __StackOneBottom, __StackOneTop; // núcleo 1, SCRATCH_X
+
+//------------- Pinta as pilhas; chamar como primeira coisa no main (núcleo 0)
+void mem_stats_init(void)
+{
+    uint32_t *sp;
+    __asm volatile("mov %0, sp" : "=r"(sp));
+    // Laços sem chamadas: nada abaixo do SP atual está vivo enquanto pintamos
+    for (uint32_t *p = &__StackBottom; p < sp - MARGEM_SP / sizeof(uint32_t); p++)
+        *p = PADRAO_PILHA;
+    // O núcleo 1 ainda não foi iniciado: a pilha dele está toda livre
+    for (uint32_t *p = &__StackOneBottom; p < &__StackOneTop; p++)
+        *p = PADRAO_PILHA;
+}
+
+uint32_t mem_stack_size(unsigned core)
+{
+    return core == 0 ? (uint32_t)((uintptr_t)&__StackTop - (uintptr_t)&__StackBottom)
+                     : (uint32_t)((uintptr_t)&__StackOneTop - (uintptr_t)&__StackOneBottom);
+}
+
+//------------- Bytes de pilha já usados (a pilha cresce para baixo a partir do topo)
+uint32_t mem_stack_high_water(unsigned core)
+{
+    const uint32_t *p = core == 0 ? &__StackBottom : &__StackOneBottom;
+    const uint32_t *topo = core == 0 ? &__StackTop : &__StackOneTop;
+    while (p < topo && *p == PADRAO_PILHA)
+        p++;
+    return (uint32_t)((uintptr_t)topo - (uintptr_t)p);
+}
+
+//------------- Imprime marcas d'água de pilha e uso de heap
+void mem_stats_report(void)
+{
+    struct mallinfo mi = mallinfo();
+    printf("[MEM] pilha core0: %lu/%lu B, core1: %lu/%lu B, heap libc: %u em uso (arena %u)\n",
+           (unsigned long)mem_stack_high_water(0), (unsigned long)mem_stack_size(0),
+           (unsigned long)mem_stack_high_water(1), (unsigned long)mem_stack_size(1),
+           (unsigned)mi.uordblks, (unsigned)mi.arena);
+#if MEM_STATS_LWIP
+    printf("[MEM] heap lwIP: %u/%u B (máx %u, erros %u)\n",
+           (unsigned)lwip_stats.mem.used, (unsigned)lwip_stats.mem.avail,
+           (unsigned)lwip_stats.mem.max, (unsigned)lwip_stats.mem.err);
+    for (int i = 0; i < MEMP_MAX; i++)
+    {
+        const struct stats_mem *pool = lwip_stats.memp[i];
+        if (pool && pool->max)
+            printf("[MEM]   %-16s %u/%u (máx %u, erros %u)\n", pool->name, (unsigned)pool->used,
+                   (unsigned)pool->avail, (unsigned)pool->max, (unsigned)pool->err);
+    }
+#endif
+}
@@ -0,0 +1,31 @@
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+// Medição de memória em tempo de execução para o modo de alocação estática
+// (-DSTATIC_ALLOC=ON no CMake):
+//  - as pilhas dos dois núcleos são "pintadas" com um padrão no início do main e a
+//    marca d'água (maior profundidade já usada) é obtida procurando o padrão intacto;
+//  - o relatório inclui o heap da libc e, nos servidores web, o heap e os pools do lwIP.
+//
+// Fora desse modo as macros não geram código.
+
+#include <stdint.h>
+
+#if STATIC_ALLOC
+
+void mem_stats_init(void);
+uint32_t mem_stack_high_water(unsigned core);
+uint32_t mem_stack_size(unsigned core);
+void mem_stats_report(void);
+
+#define MEM_STATS_INIT()   mem_stats_init()
+#define MEM_STATS_REPORT() mem_stats_report()
+
+#else
+
+#define MEM_STATS_INIT()   ((void)0)
+#define MEM_STATS_REPORT() ((void)0)
+
+#endif // STATIC_ALLOC
+
+#endif // MEM_STATS_H
@@ -0,0 +1,187 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "hardware/structs/systick.h"
+#include "profiler.h"
+#include "trace_rec.h"
+#include "deadline.h"
+
+#define MASCARA      (PROFILER_SLOTS - 1)
+#define MAX_SONDAGEM 8 // tentativas na tabela antes de contar a amostra como perdida
+
+#if PROFILER_SLOTS & MASCARA
+#error "PROFILER_SLOTS precisa ser potência de 2"
+#endif
+
+static uint32_t pcs[PROFILER_SLOTS];
+static uint32_t contagens[PROFILER_SLOTS];
+static volatile uint32_t amostras, perdidas;
+static volatile uint32_t soma_ciclos, max_ciclos;
+static uint alarme;
+static uint32_t proximo_us;
+
+//------------- Corpo do ISR (em RAM): conta o PC do quadro empilhado pela exceção
+void __not_in_flash_func(profiler_isr_amostrar)(const uint32_t *quadro)
+{
+    uint32_t t0 = systick_hw->cvr;
+    timer_hw->intr = 1u << alarme;
+    proximo_us += PROFILER_PERIOD_US; // período fixo, sem acumular o atraso do ISR
+    if ((int32_t)(proximo_us - timer_hw->timerawl) <= 0)
+        proximo_us = timer_hw->timerawl + PROFILER_PERIOD_US; // parado no depurador
+    timer_hw->alarm[alarme] = proximo_us;
+
+    // Quadro: r0, r1, r2, r3, r12, lr, pc, xpsr
+    uint32_t pc = quadro[6] & ~1u;
+    uint32_t i = ((pc >> 1) * 2654435761u) >> 16; // hash multiplicativo (Knuth)
+    for (int k = 0; k < MAX_SONDAGEM; k++, i++)
+    {
+        uint32_t j = i & MASCARA;
+        if (pcs[j] == pc)
+        {
+            contagens[j]++;
+            break;
+        }
+        if (contagens[j] == 0)
+        {
+            pcs[j] = pc;
+            contagens[j] = 1;
+            break;
+        }
+        if (k == MAX_SONDAGEM - 1)
+            perdidas++;
+    }
+    amostras++;
+
+    uint32_t ciclos = (t0 - systick_hw->cvr) & 0xffffffu; // SysTick conta para baixo, 24 bits
+    soma_ciclos += ciclos;
+    if (ciclos > max_ciclos)
+        max_ciclos = ciclos;
+}
+
+// Entrada da interrupção: sem prólogo, o SP ainda aponta para o quadro empilhado.
+// O bit 2 do EXC_RETURN (lr) diz se foi na pilha principal (MSP) ou de processo (PSP).
+void __attribute__((naked)) __not_in_flash_func(profiler_isr)(void)
+{
+    __asm volatile(
+        "movs r0, #4                  \n"
+        "mov  r1, lr                  \n"
+        "tst  r0, r1                  \n"
+        "bne  1f                      \n"
+        "mrs  r0, msp                 \n"
+        "b    2f                      \n"
+        "1:                           \n"
+        "mrs  r0, psp                 \n"
+        "2:                           \n"
+        "ldr  r2, =profiler_isr_amostrar \n"
+        "bx   r2                      \n" // retorna da exceção direto para o código interrompido
+        ".ltorg                       \n");
+}
+
+//------------- Reserva um alarme de hardware e começa a amostrar
+void profiler_init(void)
+{
+    // SysTick livre no clock do processador, só para medir o custo do ISR
+    systick_hw->rvr = 0xffffffu;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+
+    alarme = (uint)hardware_alarm_claim_unused(true);
+    uint irq = hardware_alarm_get_irq_num(alarme);
+    irq_set_exclusive_handler(irq, profiler_isr);
+    irq_set_priority(irq, PICO_HIGHEST_IRQ_PRIORITY); // amostra também dentro de outros ISRs
+    hw_set_bits(&timer_hw->inte, 1u << alarme);
+    irq_set_enabled(irq, true);
+    proximo_us = timer_hw->timerawl + PROFILER_PERIOD_US;
+    timer_hw->alarm[alarme] = proximo_us;
+}
+
+void profiler_reset(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    memset(pcs, 0, sizeof(pcs));
+    memset(contagens, 0, sizeof(contagens));
+    amostras = perdidas = soma_ciclos = max_ciclos = 0;
+    restore_interrupts(irq);
+}
+
+void profiler_stream_init(profiler_stream_t *s)
+{
+    s->slot = 0;
+    s->etapa = 0;
+}
+
+//------------- Gera o dump em texto, linha a linha, até 'max' bytes por chamada
+size_t profiler_gerar(void *estado, char *buf, size_t max, bool *fim)
+{
+    profiler_stream_t *s = estado;
+    size_t usado = 0;
+    char linha[112];
+    while (s->etapa < 3)
+    {
+        int n;
+        if (s->etapa == 0)
+        {
+            uint32_t a = amostras;
+            n = snprintf(linha, sizeof(linha),
+                         "#PRF-BEGIN hz=%lu amostras=%lu perdidas=%lu ciclos_med=%lu ciclos_max=%lu\n",
+                         (unsigned long)(1000000u / PROFILER_PERIOD_US), (unsigned long)a,
+                         (unsigned long)perdidas, (unsigned long)(a ? soma_ciclos / a : 0),
+                         (unsigned long)max_ciclos);
+        }
+        else if (s->etapa == 1)
+        {
+            while (s->slot < PROFILER_SLOTS && contagens[s->slot] == 0)
+                s->slot++;
+            if (s->slot == PROFILER_SLOTS)
+            {
+                s->etapa = 2;
+                continue;
+            }
+            n = snprintf(linha, sizeof(linha), "#PRF %08lx %lu\n",
+                         (unsigned long)pcs[s->slot], (unsigned long)contagens[s->slot]);
+        }
+        else
+            n = snprintf(linha, sizeof(linha), "#PRF-END\n");
+
+        if (n < 0 || usado + (size_t)n > max)
+            break;
+        memcpy(buf + usado, linha, n);
+        usado += n;
+        if (s->etapa == 1)
+            s->slot++;
+        else
+            s->etapa++;
+    }
+    *fim = s->etapa == 3;
+    return usado;
+}
+
+//------------- Envia o histograma pela UART
+void profiler_dump(void)
+{
+    profiler_stream_t s;
+    char buf[256];
+    bool fim = false;
+    profiler_stream_init(&s);
+    DEADLINE_PAUSE(); // ~1 s pela UART: fora dos prazos do laço
+    while (!fim)
+        fwrite(buf, 1, profiler_gerar(&s, buf, sizeof(buf), &fim), stdout);
+    fflush(stdout);
+    DEADLINE_RESUME();
+}
+
+//------------- Chamada no loop principal: 'P' despeja, 'Z' zera; o resto vai para o trace
+void profiler_poll(void)
+{
+    int c = getchar_timeout_us(0);
+    if (c == 'P')
+        profiler_dump();
+    else if (c == 'Z')
+        profiler_reset();
+#if TRACE_REC
+    trace_rec_command(c);
+#endif
+}
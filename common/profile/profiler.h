@@ -0,0 +1,56 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Profiler estatístico na placa: um alarme de hardware dedicado interrompe o núcleo 0
+// a ~1 kHz (período que não é múltiplo dos laços de 1 ms/100 ms, para não sincronizar
+// com eles) e conta o PC interrompido, lido do quadro de exceção, numa tabela hash.
+// Com prioridade máxima a interrupção também amostra dentro de outros ISRs (lwIP,
+// cyw43, timers). O custo do corpo do ISR é medido em ciclos pelo SysTick.
+//
+// Dump em texto, pela UART ('P' despeja, 'Z' zera) ou por GET /profile nos servidores:
+//   #PRF-BEGIN hz=<hz> amostras=<n> perdidas=<n> ciclos_med=<n> ciclos_max=<n>
+//   #PRF <pc em hex> <contagem>
+//   #PRF-END
+// tools/profile_report.py simboliza contra o ELF e imprime o top-N.
+//
+// Compilado apenas com -DPROFILER=ON no CMake (funciona em Release); caso contrário
+// as macros somem.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef PROFILER_PERIOD_US
+#define PROFILER_PERIOD_US 1009 // ~991 Hz, primo
+#endif
+#ifndef PROFILER_SLOTS
+#define PROFILER_SLOTS 512 // PCs distintos (8 bytes cada); precisa ser potência de 2
+#endif
+
+// Estado de um dump em andamento (gerador compatível com http_stream)
+typedef struct profiler_stream_t
+{
+    uint16_t slot;
+    uint8_t etapa; // cabeçalho, linhas, fim
+} profiler_stream_t;
+
+#if PROFILER
+
+void profiler_init(void);
+void profiler_reset(void);
+void profiler_stream_init(profiler_stream_t *s);
+size_t profiler_gerar(void *estado, char *buf, size_t max, bool *fim);
+void profiler_dump(void);
+void profiler_poll(void);
+
+#define PROFILER_INIT()  profiler_init()
+#define PROFILER_POLL()  profiler_poll()
+
+#else
+
+#define PROFILER_INIT()  ((void)0)
+#define PROFILER_POLL()  ((void)0)
+
+#endif // PROFILER
+
+#endif // PROFILER_H
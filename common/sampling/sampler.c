@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/sync.h"
+#include "sampler.h"
+#include "trace_rec.h"
+#include "deadline.h"
+#include "hot_path.h"
+
+static sampler_group_t *grupos;
+static repeating_timer_t timer_amostragem;
+static uint32_t frequencia_hz;
+static volatile uint32_t ticks;
+static volatile uint32_t ocupado_us, pior_us; // custo do tratador desde o último relatório
+static uint32_t ticks_relatorio, inicio_relatorio_us;
+DEADLINE_TASK(tarefa_amostragem, "amostragem", 50);
+
+void sampler_add(sampler_group_t *g)
+{
+    if (g->divisor == 0)
+        g->divisor = 1;
+    uint32_t irq = save_and_disable_interrupts();
+    g->proximo = grupos;
+    grupos = g;
+    restore_interrupts(irq);
+}
+
+//------------- Timer da frequência base: lê os grupos que vencem neste tick
+static bool HOT_PATH(amostrar)(repeating_timer_t *t)
+{
+    (void)t;
+    uint32_t inicio = time_us_32();
+    uint32_t tick = ticks++;
+    for (sampler_group_t *g = grupos; g; g = g->proximo)
+    {
+        if (tick % g->divisor)
+            continue;
+        uint16_t leituras[SAMPLER_MAX_ENTRADAS];
+        for (int i = 0; i < g->n; i++)
+        {
+            adc_select_input(g->entradas[i]);
+            leituras[i] = adc_read();
+            g->ultima[i] = leituras[i];
+        }
+        // No trace basta SAMPLER_TRACE_HZ por grupo; o replay repete a última leitura
+        uint32_t decimacao = frequencia_hz / g->divisor / SAMPLER_TRACE_HZ;
+        if (decimacao <= 1 || g->leituras % decimacao == 0)
+            for (int i = 0; i < g->n; i++)
+                TRACE_ADC(g->entradas[i], leituras[i]);
+        g->leituras++;
+        if (g->consumir)
+            g->consumir(leituras);
+    }
+    DEADLINE_CHECKIN(tarefa_amostragem);
+    uint32_t custo = time_us_32() - inicio;
+    ocupado_us += custo;
+    if (custo > pior_us)
+        pior_us = custo;
+    return true;
+}
+
+bool sampler_start(uint32_t hz)
+{
+    frequencia_hz = hz;
+    inicio_relatorio_us = time_us_32();
+    DEADLINE_TASK_START(tarefa_amostragem);
+    return add_repeating_timer_us(-(int64_t)(1000000 / hz), amostrar, NULL, &timer_amostragem);
+}
+
+void sampler_report(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t n = ticks - ticks_relatorio, ocupado = ocupado_us, pior = pior_us;
+    ticks_relatorio = ticks;
+    ocupado_us = 0;
+    pior_us = 0;
+    restore_interrupts(irq);
+
+    uint32_t agora = time_us_32();
+    uint32_t janela = agora - inicio_relatorio_us;
+    inicio_relatorio_us = agora;
+    uint32_t p = janela ? (uint32_t)((uint64_t)ocupado * 10000u / janela) : 0;
+    printf("[SAMPLER] %lu Hz: ticks=%lu med=%lu us pior=%lu us cpu=%lu.%02lu%%",
+           (unsigned long)frequencia_hz, (unsigned long)n, (unsigned long)(n ? ocupado / n : 0),
+           (unsigned long)pior, (unsigned long)(p / 100), (unsigned long)(p % 100));
+    for (sampler_group_t *g = grupos; g; g = g->proximo)
+        printf(" %s=%lu", g->nome, (unsigned long)g->leituras);
+    printf("\n");
+}
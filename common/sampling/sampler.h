@@ -0,0 +1,59 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+// Motor de amostragem único do firmware: um timer repetitivo na frequência base lê
+// as entradas do ADC de cada grupo registrado pelos módulos, a cada 'divisor' ticks,
+// e entrega as leituras ao consumidor do grupo ainda na interrupção (por exemplo o
+// filtro do joystick). Só ele mexe no multiplexador do ADC, então um módulo não troca
+// a entrada no meio da conversão de outro. A última leitura de cada grupo fica em
+// 'ultima' para o laço principal.
+//
+//   SAMPLER_GROUP(grupo_temp, "temperatura", 100, NULL, 4);  // ADC4 a cada 100 ticks
+//   sampler_add(&grupo_temp);
+//   ...
+//   sampler_start(1000);
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SAMPLER_MAX_ENTRADAS
+#define SAMPLER_MAX_ENTRADAS 3 // entradas do ADC por grupo
+#endif
+#ifndef SAMPLER_TRACE_HZ
+#define SAMPLER_TRACE_HZ 100 // leituras gravadas no trace por grupo (TRACE_REC)
+#endif
+
+// Chamado na interrupção com uma leitura por entrada, na ordem do grupo
+typedef void (*sampler_consumidor_fn)(const uint16_t *leituras);
+
+typedef struct sampler_group_t
+{
+    const char *nome;
+    uint8_t entradas[SAMPLER_MAX_ENTRADAS];
+    uint8_t n;
+    uint16_t divisor;                  // lê a cada 'divisor' ticks da frequência base
+    sampler_consumidor_fn consumir;    // pode ser NULL
+    volatile uint16_t ultima[SAMPLER_MAX_ENTRADAS];
+    volatile uint32_t leituras;
+    struct sampler_group_t *proximo;
+} sampler_group_t;
+
+#define SAMPLER_GROUP(var, nome_grupo, div, consumidor, ...)          \
+    static sampler_group_t var = {                                    \
+        .nome = (nome_grupo),                                         \
+        .entradas = {__VA_ARGS__},                                    \
+        .n = sizeof((uint8_t[]){__VA_ARGS__}),                        \
+        .divisor = (div),                                             \
+        .consumir = (consumidor)}
+
+// Registra um grupo; pode ser chamado antes ou depois de sampler_start
+void sampler_add(sampler_group_t *g);
+
+// Liga o timer na frequência base (Hz); o adc_init fica com a aplicação, antes de
+// ligar o sensor de temperatura. Retorna false se não houver timer livre.
+bool sampler_start(uint32_t hz);
+
+// Imprime ticks, custo médio e pior do tratador e a fatia de CPU que ele ocupa
+void sampler_report(void);
+
+#endif // SAMPLER_H
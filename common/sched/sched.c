@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "sched.h"
+
+static sched_task_t *tarefas;  // na ordem de registro (relatório)
+static uint64_t inicio_janela_us;
+static uint64_t ocioso_us;     // dormindo em sleep_until na janela atual
+static sched_task_t *em_execucao; // tarefa rodando agora (o relatório roda dentro de uma)
+static uint64_t inicio_execucao_us;
+static bool rodando;
+DEADLINE_TASK(tarefa_sched, "escalonador", SCHED_CHECKIN_MS);
+
+void sched_add(sched_task_t *t, uint32_t atraso_ms)
+{
+    // Antes do sched_run o atraso conta a partir do início do laço, não do boot: a
+    // conexão ao Wi-Fi não vira atraso nem liberações perdidas
+    t->proximo_us = (rodando ? time_us_64() : 0) + (uint64_t)atraso_ms * 1000u;
+    t->ativa = true;
+    t->proxima = NULL;
+    sched_task_t **p = &tarefas;
+    while (*p)
+        p = &(*p)->proxima;
+    *p = t;
+}
+
+void sched_next_ms(sched_task_t *t, uint32_t ms)
+{
+    t->proximo_us = t->liberacao_us + (uint64_t)ms * 1000u;
+    t->ativa = true;
+}
+
+//------------- Tarefa pronta de maior prioridade; 'proxima' recebe a liberação mais cedo das outras
+static sched_task_t *escolher(uint64_t agora, uint64_t *proxima)
+{
+    sched_task_t *melhor = NULL;
+    *proxima = UINT64_MAX;
+    for (sched_task_t *t = tarefas; t; t = t->proxima)
+    {
+        if (!t->ativa)
+            continue;
+        if (t->proximo_us > agora)
+        {
+            if (t->proximo_us < *proxima)
+                *proxima = t->proximo_us;
+            continue;
+        }
+        if (!melhor || t->prioridade < melhor->prioridade ||
+            (t->prioridade == melhor->prioridade && t->proximo_us < melhor->proximo_us))
+            melhor = t;
+    }
+    return melhor;
+}
+
+//------------- Roda uma liberação de t até o fim e agenda a seguinte
+static void executar(sched_task_t *t, uint64_t agora)
+{
+    uint32_t atraso = (uint32_t)(agora - t->proximo_us);
+    if (atraso > t->pior_atraso_us)
+        t->pior_atraso_us = atraso;
+    t->liberacao_us = t->proximo_us;
+    // Padrão: próximo período; sem período a tarefa para até chamar sched_next_ms
+    t->proximo_us += t->periodo_us;
+    t->ativa = t->periodo_us > 0;
+
+    em_execucao = t;
+    inicio_execucao_us = agora;
+    DEADLINE_BEGIN(t->fase);
+    t->fn();
+    DEADLINE_END(t->fase);
+    em_execucao = NULL;
+
+    uint64_t fim = time_us_64();
+    uint32_t duracao = (uint32_t)(fim - agora);
+    t->execucoes++;
+    t->execucoes_janela++;
+    // Um sched_report chamado por esta execução já contou a parte anterior a ele
+    t->ocupado_us += fim - (agora > inicio_janela_us ? agora : inicio_janela_us);
+    if (duracao > t->pior_us)
+        t->pior_us = duracao;
+    if (t->periodo_us && t->proximo_us + t->periodo_us <= fim)
+    { // passou mais de um período inteiro: pula as liberações vencidas em vez de emendá-las
+        uint64_t puladas = (fim - t->proximo_us) / t->periodo_us;
+        t->perdidas += (uint32_t)puladas;
+        t->proximo_us += puladas * t->periodo_us;
+    }
+}
+
+void sched_run(void)
+{
+    inicio_janela_us = time_us_64();
+    for (sched_task_t *t = tarefas; t; t = t->proxima)
+        t->proximo_us += inicio_janela_us;
+    rodando = true;
+    DEADLINE_TASK_START(tarefa_sched);
+    for (;;)
+    {
+        DEADLINE_CHECKIN(tarefa_sched);
+        uint64_t agora = time_us_64(), proxima;
+        sched_task_t *t = escolher(agora, &proxima);
+        if (t)
+        {
+            executar(t, agora);
+            continue;
+        }
+        // Nada pronto: dorme até a próxima liberação, acordando a tempo do check-in
+        uint64_t limite = agora + SCHED_CHECKIN_MS * 500u;
+        if (proxima > limite)
+            proxima = limite;
+        sleep_until(from_us_since_boot(proxima));
+        ocioso_us += time_us_64() - agora;
+    }
+}
+
+// Centésimos de ponto percentual de parte/total, para imprimir sem float
+static void porcento(uint64_t parte, uint64_t total, unsigned long *inteiro, unsigned long *centesimos)
+{
+    uint64_t p = total ? parte * 10000u / total : 0;
+    *inteiro = (unsigned long)(p / 100);
+    *centesimos = (unsigned long)(p % 100);
+}
+
+void sched_report(void)
+{
+    uint64_t agora = time_us_64();
+    uint64_t janela = agora - inicio_janela_us, tarefas_us = 0;
+    unsigned long i, c;
+    if (!janela)
+        return;
+    for (sched_task_t *t = tarefas; t; t = t->proxima)
+    {
+        // A tarefa que chamou o relatório ainda está rodando: conta o trecho até agora
+        uint64_t ocupado = t->ocupado_us;
+        if (t == em_execucao)
+            ocupado += agora - (inicio_execucao_us > inicio_janela_us ? inicio_execucao_us : inicio_janela_us);
+        tarefas_us += ocupado;
+        porcento(ocupado, janela, &i, &c);
+        printf("[SCHED] %-12s prio=%u exec=%lu cpu=%lu.%02lu%% med=%lu us pior=%lu us atraso_max=%lu us perdidas=%lu\n",
+               t->nome, t->prioridade, (unsigned long)t->execucoes_janela, i, c,
+               (unsigned long)(t->execucoes_janela ? ocupado / t->execucoes_janela : 0),
+               (unsigned long)t->pior_us, (unsigned long)t->pior_atraso_us, (unsigned long)t->perdidas);
+        t->ocupado_us = 0;
+        t->execucoes_janela = 0;
+    }
+    // O resto da janela é o próprio laço do escalonador (e as interrupções que caíram nele)
+    uint64_t resto = janela > tarefas_us + ocioso_us ? janela - tarefas_us - ocioso_us : 0;
+    unsigned long oi, oc;
+    porcento(ocioso_us, janela, &oi, &oc);
+    porcento(resto, janela, &i, &c);
+    printf("[SCHED] janela=%lu ms ocioso=%lu.%02lu%% escalonador=%lu.%02lu%%\n",
+           (unsigned long)(janela / 1000), oi, oc, i, c);
+    ocioso_us = 0;
+    inicio_janela_us = agora;
+}
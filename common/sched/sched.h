@@ -0,0 +1,69 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+// Escalonador cooperativo run-to-completion: cada tarefa é uma função curta chamada
+// no seu período e que sempre retorna (nada de sleep dentro dela). Entre as tarefas
+// prontas roda a de maior prioridade (menor número); com empate, a mais atrasada.
+// Sem tarefa pronta, o núcleo dorme até a próxima liberação.
+//
+// As liberações são contadas a partir do instante planejado, não do fim da execução,
+// então o período não acumula deriva. Uma tarefa com sequência de passos (o semáforo)
+// escolhe o próprio próximo instante com sched_next_ms.
+//
+// Medições por tarefa: tempo de CPU na janela do relatório, duração média e pior,
+// atraso de liberação (início real - planejado) e liberações perdidas. Cada tarefa
+// também é uma fase do monitor de prazos (deadline.h) com o orçamento declarado, e o
+// laço do escalonador dá check-in na tarefa "escalonador" do watchdog.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "deadline.h"
+
+#ifndef SCHED_CHECKIN_MS
+#define SCHED_CHECKIN_MS 1000 // maior intervalo sem o laço do escalonador voltar
+#endif
+
+typedef void (*sched_fn)(void);
+
+typedef struct sched_task_t
+{
+    const char *nome;
+    sched_fn fn;
+    uint32_t periodo_us; // 0 = só roda quando a própria tarefa marca com sched_next_ms
+    uint8_t prioridade;  // 0 = mais alta
+    deadline_phase_t fase;
+    uint64_t proximo_us; // próxima liberação planejada
+    uint64_t liberacao_us; // liberação planejada da execução atual (ou da última)
+    bool ativa;
+    uint32_t execucoes;
+    uint32_t perdidas;    // liberações puladas por atraso maior que um período
+    uint32_t pior_us;     // maior duração de uma execução
+    uint32_t pior_atraso_us;
+    uint64_t ocupado_us;  // CPU na janela atual
+    uint32_t execucoes_janela;
+    struct sched_task_t *proxima;
+} sched_task_t;
+
+#define SCHED_TASK(var, nome_tarefa, funcao, periodo_ms, prio, orcamento_ms)                   \
+    static sched_task_t var = {                                                             \
+        .nome = (nome_tarefa),                                                              \
+        .fn = (funcao),                                                                     \
+        .periodo_us = (uint32_t)(periodo_ms) * 1000u,                                       \
+        .prioridade = (prio),                                                               \
+        .fase = {.nome = (nome_tarefa), .orcamento_us = (uint32_t)(orcamento_ms) * 1000u}}
+
+// Registra a tarefa; a primeira liberação é 'atraso_ms' depois de agora ou, antes do
+// sched_run, depois do início do laço
+void sched_add(sched_task_t *t, uint32_t atraso_ms);
+
+// Próxima liberação de t 'ms' depois da liberação planejada atual (chamar de dentro
+// da própria tarefa; substitui o período nesta vez)
+void sched_next_ms(sched_task_t *t, uint32_t ms);
+
+// Laço do escalonador; não retorna
+void sched_run(void) __attribute__((noreturn));
+
+// Imprime a fatia de CPU de cada tarefa e do ocioso desde o último relatório e zera a janela
+void sched_report(void);
+
+#endif // SCHED_H
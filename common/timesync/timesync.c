@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "timesync.h"
+
+// ref = local + desvio + (local - base) * taxa / 1e9
+static int64_t desvio_us;
+static uint64_t base_us;
+static int32_t taxa_ppb;
+static uint32_t amostras, saltos, descartadas;
+static int32_t ultimo_erro_us, pior_erro_us;
+
+static uint64_t para_ref(uint64_t local_us)
+{
+    int64_t dt = (int64_t)(local_us - base_us);
+    return local_us + desvio_us + dt * taxa_ppb / 1000000000;
+}
+
+uint64_t timesync_to_ref(uint64_t local_us)
+{
+    uint32_t irq = save_and_disable_interrupts(); // a fonte atualiza em interrupção
+    uint64_t r = para_ref(local_us);
+    restore_interrupts(irq);
+    return r;
+}
+
+uint64_t timesync_to_local(uint64_t ref_us)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    // Inversa de para_ref em primeira ordem; o resto é da ordem de taxa² (< 1 us)
+    uint64_t l = ref_us - desvio_us;
+    int64_t dt = (int64_t)(l - base_us);
+    l -= dt * taxa_ppb / 1000000000;
+    restore_interrupts(irq);
+    return l;
+}
+
+//------------- Nova amostra da fonte: corrige a frequência pelo erro de previsão e refaz o desvio
+void timesync_sample(uint64_t ref_us, uint64_t local_us)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    int64_t erro = (int64_t)(ref_us - para_ref(local_us));
+    int64_t dt = (int64_t)(local_us - base_us);
+    if (amostras == 0 || erro > TIMESYNC_STEP_US || erro < -TIMESYNC_STEP_US)
+        saltos++; // primeira amostra ou salto: só o desvio, a frequência continua
+    else if (dt > 0)
+    {
+        // Meio ganho: o jitter da fonte (Wi-Fi, servidor) não vira oscilação da taxa
+        int64_t taxa = taxa_ppb + erro * 1000000000 / dt / 2;
+        if (taxa > TIMESYNC_TAXA_MAX_PPB || taxa < -TIMESYNC_TAXA_MAX_PPB)
+        {
+            descartadas++;
+            restore_interrupts(irq);
+            return;
+        }
+        taxa_ppb = (int32_t)taxa;
+        if (erro > pior_erro_us || -erro > pior_erro_us)
+            pior_erro_us = (int32_t)(erro < 0 ? -erro : erro);
+    }
+    ultimo_erro_us = (int32_t)(erro > INT32_MAX ? INT32_MAX : erro < -INT32_MAX ? -INT32_MAX : erro);
+    desvio_us = (int64_t)(ref_us - local_us);
+    base_us = local_us;
+    amostras++;
+    restore_interrupts(irq);
+}
+
+uint32_t timesync_steps(void)
+{
+    return saltos;
+}
+
+bool timesync_synced(void)
+{
+    return amostras > 0;
+}
+
+void timesync_report(void)
+{
+    printf("[TIMESYNC] amostras=%lu saltos=%lu descartadas=%lu taxa=%+ld ppb ultimo_erro=%+ld us pior_erro=%ld us\n",
+           (unsigned long)amostras, (unsigned long)saltos, (unsigned long)descartadas, (long)taxa_ppb,
+           (long)ultimo_erro_us, (long)pior_erro_us);
+}
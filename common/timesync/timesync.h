@@ -0,0 +1,62 @@
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+// Relógio de referência externo sobre o relógio local (time_us_64): uma fonte entrega
+// pares (referência, local) e o módulo mantém o desvio e a diferença de frequência
+// entre os dois, para converter instantes nos dois sentidos entre as amostras.
+//
+// Fontes (escolhidas no CMake com -DTIME_SYNC=NTP|LOCAL):
+//  - NTP pelo SNTP do lwIP (timesync_ntp.c), com a rede já conectada;
+//  - substituto local (timesync_local.c): um timer gera amostras de um relógio de
+//    referência sintético com erro de frequência e jitter fixos, para testar a
+//    sincronização no replay ou numa placa sem rede.
+//
+// Sem TIME_SYNC as conversões são a identidade e o relógio local é a referência.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef TIMESYNC_STEP_US
+#define TIMESYNC_STEP_US 100000 // erro de previsão acima disso é um salto, não deriva
+#endif
+#ifndef TIMESYNC_TAXA_MAX_PPB
+#define TIMESYNC_TAXA_MAX_PPB 500000 // 500 ppm: além disso a amostra é descartada
+#endif
+#ifndef TIMESYNC_PERIODO_S
+#define TIMESYNC_PERIODO_S 60 // intervalo entre amostras das fontes
+#endif
+
+#if TIMESYNC
+
+// Nova amostra: a referência valia ref_us no instante local local_us. A primeira
+// amostra e os saltos maiores que TIMESYNC_STEP_US só trocam o desvio (e contam em
+// timesync_steps); as demais também corrigem a frequência.
+void timesync_sample(uint64_t ref_us, uint64_t local_us);
+
+uint64_t timesync_to_ref(uint64_t local_us);
+uint64_t timesync_to_local(uint64_t ref_us);
+
+// Saltos do mapeamento desde o boot; quem planejou instantes na referência replaneja
+uint32_t timesync_steps(void);
+bool timesync_synced(void);
+
+// Amostras, desvio atual, frequência estimada e último erro de previsão
+void timesync_report(void);
+
+#if TIMESYNC_NTP
+void timesync_ntp_start(const char *servidor);
+#elif TIMESYNC_LOCAL
+void timesync_local_start(void);
+#endif
+
+#else
+
+static inline uint64_t timesync_to_ref(uint64_t local_us) { return local_us; }
+static inline uint64_t timesync_to_local(uint64_t ref_us) { return ref_us; }
+static inline uint32_t timesync_steps(void) { return 0; }
+static inline bool timesync_synced(void) { return false; }
+static inline void timesync_report(void) {}
+
+#endif // TIMESYNC
+
+#endif // TIMESYNC_H
@@ -0,0 +1,46 @@
+// Substituto local do NTP: um timer entrega a cada TIMESYNC_PERIODO_S uma amostra de
+// um relógio de referência sintético que anda TIMESYNC_LOCAL_PPM mais rápido que o
+// cristal da placa, com jitter uniforme de ±TIMESYNC_LOCAL_JITTER_US (a rota até o
+// servidor). A primeira amostra chega só depois de um período, como a conexão ao
+// Wi-Fi, então o primeiro ciclo já rodou no relógio local quando ela chega.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "timesync.h"
+
+#ifndef TIMESYNC_LOCAL_PPM
+#define TIMESYNC_LOCAL_PPM 50 // erro de frequência do cristal em relação à referência
+#endif
+#ifndef TIMESYNC_LOCAL_JITTER_US
+#define TIMESYNC_LOCAL_JITTER_US 2000
+#endif
+#ifndef TIMESYNC_LOCAL_BASE_US
+#define TIMESYNC_LOCAL_BASE_US 1700000000000000ull // referência no boot (Unix, us)
+#endif
+
+static repeating_timer_t timer_referencia;
+static uint32_t estado_rng = 0x2545f491;
+
+static int32_t jitter_us(void)
+{
+    estado_rng ^= estado_rng << 13;
+    estado_rng ^= estado_rng >> 17;
+    estado_rng ^= estado_rng << 5;
+    return (int32_t)(estado_rng % (2 * TIMESYNC_LOCAL_JITTER_US + 1)) - TIMESYNC_LOCAL_JITTER_US;
+}
+
+static bool amostrar_referencia(repeating_timer_t *t)
+{
+    (void)t;
+    uint64_t local = time_us_64();
+    uint64_t ref = TIMESYNC_LOCAL_BASE_US + local + (int64_t)local * TIMESYNC_LOCAL_PPM / 1000000;
+    timesync_sample(ref + jitter_us(), local);
+    return true;
+}
+
+void timesync_local_start(void)
+{
+    printf("[TIMESYNC] referência local: %+d ppm, jitter ±%u us, amostra a cada %u s\n",
+           TIMESYNC_LOCAL_PPM, TIMESYNC_LOCAL_JITTER_US, TIMESYNC_PERIODO_S);
+    add_repeating_timer_ms(TIMESYNC_PERIODO_S * 1000, amostrar_referencia, NULL, &timer_referencia);
+}
@@ -0,0 +1,33 @@
+// Fonte NTP: o SNTP do lwIP consulta o servidor a cada TIMESYNC_PERIODO_S e entrega a
+// hora (já compensada pela metade do tempo de ida e volta) por SNTP_SET_SYSTEM_TIME_US,
+// definido em common/lwip/lwipopts.h quando TIMESYNC_NTP está ligado.
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/apps/sntp.h"
+#include "timesync.h"
+
+// Segundos do NTP entre 1900 e 1970 já foram descontados pelo lwIP
+void timesync_ntp_set(uint32_t seg, uint32_t us)
+{
+    timesync_sample((uint64_t)seg * 1000000u + us, time_us_64());
+}
+
+// Hora atual na referência, para o lwIP medir o tempo de ida e volta (SNTP_COMP_ROUNDTRIP)
+void timesync_ntp_get(uint32_t *seg, uint32_t *us)
+{
+    uint64_t r = timesync_to_ref(time_us_64());
+    *seg = (uint32_t)(r / 1000000u);
+    *us = (uint32_t)(r % 1000000u);
+}
+
+void timesync_ntp_start(const char *servidor)
+{
+    cyw43_arch_lwip_begin();
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, servidor);
+    sntp_init();
+    cyw43_arch_lwip_end();
+    printf("[TIMESYNC] NTP em %s a cada %u s\n", servidor, TIMESYNC_PERIODO_S);
+}
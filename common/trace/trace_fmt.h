@@ -0,0 +1,53 @@
+#ifndef TRACE_FMT_H
+#define TRACE_FMT_H
+
+// Formato binário dos traces de entrada (record/replay).
+// O mesmo arquivo é usado pelo gravador na placa e pelo motor de replay no host.
+//
+// Layout: trace_header_t seguido de 'count' eventos trace_event_t (little-endian).
+// O tempo de cada evento é relativo ao anterior (dt_us), o que mantém o registro em
+// 8 bytes; intervalos maiores que ~71 min são quebrados com eventos TRACE_EV_SKIP.
+
+#include <stdint.h>
+
+#define TRACE_MAGIC   0x31435254u // "TRC1"
+#define TRACE_VERSION 1
+
+typedef enum trace_event_type
+{
+    TRACE_EV_SKIP = 0, // só avança o tempo
+    TRACE_EV_GPIO = 1, // channel = pino, value = nível lógico após a borda
+    TRACE_EV_ADC  = 2, // channel = entrada do ADC (0..4), value = leitura bruta de 12 bits
+    TRACE_EV_HTTP = 3, // channel = índice do caminho (TRACE_HTTP_*), value = parâmetro
+} trace_event_type;
+
+// Caminhos HTTP conhecidos pelo replay
+#define TRACE_HTTP_ROOT        0 // "/"
+#define TRACE_HTTP_HISTORY_CSV 1 // "/history?since=<value>&fmt=csv"
+#define TRACE_HTTP_HISTORY_BIN 2 // "/history?since=<value>&fmt=bin"
+#define TRACE_HTTP_ROOT_HISTORY 3 // "/" e "/history?since=<value>&fmt=csv" na mesma conexão
+                                  // (keep-alive), o 2º antes da confirmação do 1º (só no host)
+
+typedef struct __attribute__((packed)) trace_header_t
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags; // TRACE_FLAG_*
+    uint32_t count; // número de eventos
+    uint32_t reserved; // gravador: despejos anteriores desde o início da gravação
+} trace_header_t;
+
+#define TRACE_FLAG_OVERFLOW     0x0001 // o gravador ficou sem espaço e descartou eventos
+#define TRACE_FLAG_SYNTH        0x0002 // gerado sinteticamente no host
+#define TRACE_FLAG_CONTINUATION 0x0004 // continua o despejo anterior: o 1º dt é relativo ao
+                                       // último evento dele (só nos blocos do log da UART)
+
+typedef struct __attribute__((packed)) trace_event_t
+{
+    uint32_t dt_us; // tempo desde o evento anterior
+    uint8_t type;   // trace_event_type
+    uint8_t channel;
+    uint16_t value;
+} trace_event_t;
+
+#endif // TRACE_FMT_H
@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "trace_rec.h"
+#include "deadline.h"
+
+#define TRACE_MAX_PINS   30
+#define TRACE_MAX_INPUTS 5
+
+// Dois bancos: a interrupção grava num enquanto o laço principal despeja o outro pela
+// UART, então nada se perde durante o despejo (que leva segundos)
+#define TRACE_BANCO (TRACE_REC_CAPACITY / 2)
+
+static trace_event_t eventos[2][TRACE_BANCO]; // buffer estático, sem malloc
+static volatile uint8_t banco = 0;            // banco onde as interrupções gravam
+static volatile uint32_t num_eventos = 0;     // eventos no banco ativo
+static volatile uint16_t flags = 0;           // flags do banco ativo
+static uint32_t sequencia = 0;                // despejos desde o trace_rec_init
+static uint64_t ultimo_evento_us = 0;
+
+static int8_t ultimo_nivel[TRACE_MAX_PINS];      // -1 = ainda não observado
+static int32_t ultima_amostra[TRACE_MAX_INPUTS]; // -1 = ainda não observada
+
+//------------- Inicia a gravação; o tempo zero do trace é o instante desta chamada
+void trace_rec_init(void)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    banco = 0;
+    num_eventos = 0;
+    flags = 0;
+    sequencia = 0;
+    ultimo_evento_us = time_us_64();
+    memset(ultimo_nivel, -1, sizeof(ultimo_nivel));
+    for (int i = 0; i < TRACE_MAX_INPUTS; i++)
+        ultima_amostra[i] = -1;
+    restore_interrupts(irq);
+}
+
+// Grava um evento no banco ativo; quem chama já desligou as interrupções
+static void gravar(uint8_t type, uint8_t channel, uint16_t value)
+{
+    trace_event_t *destino = eventos[banco];
+    uint64_t agora = time_us_64();
+    uint64_t dt = agora - ultimo_evento_us;
+
+    // Intervalos que não cabem em 32 bits viram eventos de SKIP; cada SKIP gravado já
+    // conta no tempo, para não ser repetido se o evento em si não couber
+    while (dt > UINT32_MAX && num_eventos < TRACE_BANCO)
+    {
+        destino[num_eventos++] = (trace_event_t){UINT32_MAX, TRACE_EV_SKIP, 0, 0};
+        dt -= UINT32_MAX;
+        ultimo_evento_us += UINT32_MAX;
+    }
+    if (num_eventos < TRACE_BANCO)
+    {
+        destino[num_eventos++] = (trace_event_t){(uint32_t)dt, type, channel, value};
+        ultimo_evento_us = agora;
+    }
+    else
+    {
+        flags |= TRACE_FLAG_OVERFLOW;
+    }
+}
+
+//------------- Acrescenta um evento (pode ser chamada de interrupções)
+void trace_rec_event(uint8_t type, uint8_t channel, uint16_t value)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    gravar(type, channel, value);
+    restore_interrupts(irq);
+}
+
+//------------- Registra o nível de um pino apenas quando ele muda (bordas)
+void trace_rec_gpio(uint8_t pin, bool level)
+{
+    if (pin >= TRACE_MAX_PINS)
+        return;
+    // Comparação e gravação juntas: uma interrupção no meio não duplica nem perde a borda
+    uint32_t irq = save_and_disable_interrupts();
+    if (ultimo_nivel[pin] != (int8_t)level)
+    {
+        ultimo_nivel[pin] = level;
+        gravar(TRACE_EV_GPIO, pin, level);
+    }
+    restore_interrupts(irq);
+}
+
+//------------- Registra uma amostra do ADC, descartando repetições
+void trace_rec_adc(uint8_t input, uint16_t raw)
+{
+    if (input >= TRACE_MAX_INPUTS)
+        return;
+    uint32_t irq = save_and_disable_interrupts();
+    if (ultima_amostra[input] != raw)
+    {
+        ultima_amostra[input] = raw;
+        gravar(TRACE_EV_ADC, input, raw);
+    }
+    restore_interrupts(irq);
+}
+
+static void dump_bytes(const uint8_t *dados, uint32_t tamanho)
+{
+    for (uint32_t i = 0; i < tamanho; i += 32)
+    {
+        printf("#TRC ");
+        for (uint32_t j = i; j < tamanho && j < i + 32; j++)
+            printf("%02x", dados[j]);
+        printf("\n");
+    }
+}
+
+//------------- Troca de banco e envia o cheio pela UART; a gravação continua no outro
+void trace_rec_dump(void)
+{
+    // O estado das deltas (último evento, nível, amostra) segue para o banco novo: o
+    // primeiro evento dele é relativo ao último deste, e o host emenda os despejos
+    uint32_t irq = save_and_disable_interrupts();
+    const trace_event_t *cheio = eventos[banco];
+    trace_header_t header = {TRACE_MAGIC, TRACE_VERSION, flags, num_eventos, sequencia};
+    if (sequencia)
+        header.flags |= TRACE_FLAG_CONTINUATION;
+    banco ^= 1;
+    num_eventos = 0;
+    flags = 0;
+    sequencia++;
+    restore_interrupts(irq);
+
+    DEADLINE_PAUSE(); // ~3 s de hex pela UART: fora dos prazos do laço
+    printf("#TRC-BEGIN\n");
+    dump_bytes((const uint8_t *)&header, sizeof(header));
+    dump_bytes((const uint8_t *)cheio, header.count * sizeof(trace_event_t));
+    printf("#TRC-END\n");
+    DEADLINE_RESUME();
+}
+
+//------------- Trata um caractere já lido da UART: despeja quando pedido ('T') ou quando o
+// banco ativo passa de TRACE_REC_DUMP_AT, antes de encher
+void trace_rec_command(int c)
+{
+    if (c == 'T' || num_eventos >= TRACE_REC_DUMP_AT || (flags & TRACE_FLAG_OVERFLOW))
+        trace_rec_dump();
+}
+
+//------------- Chamada no loop principal
+void trace_rec_poll(void)
+{
+    trace_rec_command(getchar_timeout_us(0));
+}
@@ -0,0 +1,57 @@
+#ifndef TRACE_REC_H
+#define TRACE_REC_H
+
+// Gravador de entradas na placa: registra bordas de GPIO, amostras do ADC e chegadas
+// de requisições HTTP em um buffer na RAM, no formato de trace_fmt.h.
+// O trace é despejado pela UART (linhas "#TRC <hex>") quando o caractere 'T' é
+// recebido ou quando o banco ativo chega a TRACE_REC_DUMP_AT eventos; o host converte
+// com "trace_tool import". São dois bancos de TRACE_REC_CAPACITY / 2 eventos: as
+// interrupções gravam num enquanto o outro é despejado, e cada despejo continua o
+// anterior (TRACE_FLAG_CONTINUATION), então o import emenda a sequência num só trace.
+//
+// Compilado apenas com -DTRACE_REC=ON no CMake; caso contrário as macros somem.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "trace_fmt.h"
+
+#ifndef TRACE_REC_CAPACITY
+#define TRACE_REC_CAPACITY 2048 // eventos (8 bytes cada), somando os dois bancos
+#endif
+#ifndef TRACE_REC_DUMP_AT
+#define TRACE_REC_DUMP_AT (TRACE_REC_CAPACITY / 2 * 3 / 4) // folga para o atraso do laço
+#endif
+
+#if TRACE_REC
+
+void trace_rec_init(void);
+void trace_rec_event(uint8_t type, uint8_t channel, uint16_t value);
+void trace_rec_gpio(uint8_t pin, bool level);
+void trace_rec_adc(uint8_t input, uint16_t raw);
+void trace_rec_dump(void);
+void trace_rec_command(int c);
+void trace_rec_poll(void);
+
+#define TRACE_INIT()              trace_rec_init()
+#define TRACE_GPIO(pin, level)    trace_rec_gpio((pin), (level))
+#define TRACE_ADC(input, raw)     trace_rec_adc((input), (raw))
+#define TRACE_HTTP(path, param)   trace_rec_event(TRACE_EV_HTTP, (path), (param))
+#if PROFILER
+// Com o profiler ligado, PROFILER_POLL lê a UART e repassa os outros comandos;
+// aqui só resta verificar se o buffer encheu
+#define TRACE_POLL()              trace_rec_command(-1)
+#else
+#define TRACE_POLL()              trace_rec_poll()
+#endif
+
+#else
+
+#define TRACE_INIT()              ((void)0)
+#define TRACE_GPIO(pin, level)    ((void)0)
+#define TRACE_ADC(input, raw)     ((void)0)
+#define TRACE_HTTP(path, param)   ((void)0)
+#define TRACE_POLL()              ((void)0)
+
+#endif // TRACE_REC
+
+#endif // TRACE_REC_H
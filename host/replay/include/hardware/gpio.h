@@ -0,0 +1,4 @@
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+#include "host_sdk.h"
+#endif
@@ -0,0 +1,4 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+#include "host_sdk.h"
+#endif
@@ -0,0 +1,4 @@
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+#include "host_sdk.h"
+#endif
@@ -0,0 +1,97 @@
+#ifndef HOST_LWIP_H
+#define HOST_LWIP_H
+
+// Subconjunto da API raw TCP do lwIP usado pelos servidores web.
+// Cada requisição HTTP do trace vira uma conexão simulada: accept -> recv(pedido) ->
+// confirmações (tcp_sent) até esvaziar o buffer de envio -> recv(NULL) do cliente.
+
+#include <stdint.h>
+#include "host_sdk.h"
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t s8_t;
+typedef s8_t err_t;
+
+#define ERR_OK   0
+#define ERR_MEM  -1
+#define ERR_BUF  -2
+#define ERR_VAL  -6
+#define ERR_ABRT -13
+
+// TCP_MSS, TCP_SND_BUF e os limites de pools vêm do perfil do firmware (LWIP_PROFILE)
+#include "lwipopts.h"
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+typedef struct ip4_addr
+{
+    u32_t addr;
+} ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
+
+extern const ip_addr_t host_ip_addr_any;
+#define IP_ADDR_ANY (&host_ip_addr_any)
+#define IP_ANY_TYPE (&host_ip_addr_any)
+
+struct netif
+{
+    ip_addr_t ip_addr;
+};
+extern struct netif *netif_default;
+#define netif_ip4_addr(n) (&(n)->ip_addr)
+char *ip4addr_ntoa(const ip4_addr_t *addr);
+char *ipaddr_ntoa(const ip_addr_t *addr);
+
+struct pbuf
+{
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+};
+u8_t pbuf_free(struct pbuf *p);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+struct tcp_pcb;
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+
+struct tcp_pcb
+{
+    void *callback_arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_err_fn errf;
+    tcp_poll_fn poll;
+    u8_t pollinterval;
+    u32_t id;
+    u16_t snd_buf;   // espaço livre no buffer de envio
+    u32_t unacked;   // bytes escritos e ainda não confirmados
+    bool listening;
+    bool closed;
+};
+
+struct tcp_pcb *tcp_new(void);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn errf);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+err_t tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+#define tcp_sndbuf(pcb) ((pcb)->snd_buf)
+
+#endif // HOST_LWIP_H
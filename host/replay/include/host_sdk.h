@@ -0,0 +1,133 @@
+#ifndef HOST_SDK_H
+#define HOST_SDK_H
+
+// Subconjunto do Pico SDK implementado sobre o relógio virtual do replay.
+// As aplicações são compiladas sem alterações contra estes cabeçalhos; as entradas
+// (GPIO, ADC) vêm do trace e as saídas (PWM, GPIO, PIO) vão para o log do replay.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+// ----- tempo
+absolute_time_t get_absolute_time(void);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+void sleep_until(absolute_time_t t);
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return delayed_by_ms(get_absolute_time(), ms); }
+
+// ----- timers repetitivos (disparados pelo relógio virtual, "em interrupção")
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+struct repeating_timer
+{
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+    uint64_t proximo_us;
+    bool ativo;
+};
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out);
+static inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+// ----- stdio
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+#define PICO_ERROR_TIMEOUT (-1)
+
+// ----- GPIO
+#define GPIO_IN  false
+#define GPIO_OUT true
+enum gpio_function { GPIO_FUNC_SIO = 5, GPIO_FUNC_PWM = 4, GPIO_FUNC_PIO0 = 6, GPIO_FUNC_PIO1 = 7 };
+enum gpio_irq_level { GPIO_IRQ_LEVEL_LOW = 1, GPIO_IRQ_LEVEL_HIGH = 2, GPIO_IRQ_EDGE_FALL = 4, GPIO_IRQ_EDGE_RISE = 8 };
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+void gpio_pull_down(uint gpio);
+bool gpio_get(uint gpio);
+void gpio_put(uint gpio, bool value);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback);
+
+// ----- PWM
+typedef struct
+{
+    uint32_t div16;
+    uint32_t top;
+} pwm_config;
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1u) & 7u; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+pwm_config pwm_get_default_config(void);
+static inline void pwm_config_set_clkdiv_int_frac(pwm_config *c, uint8_t integer, uint8_t fract) { c->div16 = ((uint32_t)integer << 4) | fract; }
+static inline void pwm_config_set_wrap(pwm_config *c, uint16_t wrap) { c->top = wrap; }
+void pwm_init(uint slice, pwm_config *c, bool start);
+void pwm_set_clkdiv(uint slice, float divider);
+void pwm_set_wrap(uint slice, uint16_t wrap);
+void pwm_set_chan_level(uint slice, uint chan, uint16_t level);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+void pwm_set_enabled(uint slice, bool enabled);
+
+// ----- PIO (apenas o suficiente para a matriz WS2812)
+typedef struct host_pio *PIO;
+extern struct host_pio *const host_pio_inst[2];
+#define pio0 (host_pio_inst[0])
+#define pio1 (host_pio_inst[1])
+typedef struct pio_program
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+// ----- ADC
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+void adc_set_temp_sensor_enabled(bool enable);
+
+// ----- sincronização (no replay não há interrupções concorrentes)
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+// ----- watchdog (o vencimento vira uma linha no log; não há reinício de verdade)
+typedef struct
+{
+    uint32_t scratch[8];
+} watchdog_hw_t;
+extern watchdog_hw_t *const watchdog_hw;
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+bool watchdog_caused_reboot(void);
+bool watchdog_enable_caused_reboot(void);
+
+// ----- clocks
+enum clock_index { clk_sys = 5 };
+uint32_t clock_get_hz(enum clock_index clk);
+
+#endif // HOST_SDK_H
@@ -0,0 +1,4 @@
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+#include "host_lwip.h"
+#endif
@@ -0,0 +1,4 @@
+#ifndef HOST_LWIP_NETIF_H
+#define HOST_LWIP_NETIF_H
+#include "host_lwip.h"
+#endif
@@ -0,0 +1,4 @@
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+#include "host_lwip.h"
+#endif
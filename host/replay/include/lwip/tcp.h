@@ -0,0 +1,4 @@
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+#include "host_lwip.h"
+#endif
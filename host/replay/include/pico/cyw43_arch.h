@@ -0,0 +1,20 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+// No replay o Wi-Fi sempre conecta na hora; a rede é simulada em lwip_host.c
+#include "host_sdk.h"
+#include "host_lwip.h"
+
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+
+static inline int cyw43_arch_init(void) { return 0; }
+static inline void cyw43_arch_deinit(void) {}
+static inline void cyw43_arch_enable_sta_mode(void) {}
+static inline int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout_ms)
+{
+    (void)ssid; (void)pw; (void)auth; (void)timeout_ms;
+    return 0;
+}
+static inline void cyw43_arch_poll(void) {}
+static inline void cyw43_arch_lwip_begin(void) {}
+static inline void cyw43_arch_lwip_end(void) {}
+#endif
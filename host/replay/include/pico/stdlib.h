@@ -0,0 +1,4 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+#include "host_sdk.h"
+#endif
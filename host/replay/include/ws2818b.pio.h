@@ -0,0 +1,12 @@
+#ifndef HOST_WS2818B_PIO_H
+#define HOST_WS2818B_PIO_H
+// Substitui o cabeçalho gerado pelo pioasm: o replay só observa os bytes enviados à FIFO
+#include "host_sdk.h"
+
+static const pio_program_t ws2818b_program = {0, 4, -1};
+
+static inline void ws2818b_program_init(PIO pio, uint sm, uint offset, uint pin, float freq)
+{
+    (void)pio; (void)sm; (void)offset; (void)pin; (void)freq;
+}
+#endif
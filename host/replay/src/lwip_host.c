@@ -0,0 +1,526 @@
+// Rede simulada para o replay: cada evento HTTP do trace abre uma conexão no listener
+// da aplicação, entrega o pedido, confirma o que for escrito (disparando tcp_sent) e
+// fecha pelo lado do cliente. A resposta completa vai para o log.
+//
+// Os limites de recursos do lwIP vêm do mesmo lwipopts.h do firmware (perfil do
+// LWIP_PROFILE): pcbs, heap (MEM_SIZE) ocupado pelos dados copiados, segmentos,
+// pbufs de referência das escritas sem cópia e fila por conexão. Quando um deles
+// esgota, tcp_write devolve ERR_MEM como na placa.
+//
+// Sem enlace configurado (padrão) tudo é confirmado no mesmo instante. Com -l, os
+// bytes ocupam um enlace de banda fixa e a confirmação chega um RTT depois; o pedido
+// fica aberto enquanto o relógio virtual corre e o resumo no fim mostra vazão,
+// latência e o pico de uso de cada recurso (tools/lwip_bench.py).
+
+#include <stdlib.h>
+#include <string.h>
+#include "host_lwip.h"
+#include "replay.h"
+#include "trace_fmt.h"
+
+// Limite de rodadas de confirmação por conexão (protege contra laços na aplicação)
+#define MAX_RODADAS 100000
+
+// Custo de cada segmento no heap do lwIP (struct pbuf, cabeçalhos TCP/IP/Ethernet e
+// o cabeçalho do mem_malloc) e no enlace (cabeçalhos)
+#define HEAP_POR_SEGMENTO   80
+#define FIO_POR_SEGMENTO    54
+
+// Tamanhos das estruturas do lwIP 2.1 compilado para o Cortex-M0+ (32 bits), para a
+// estimativa de RAM estática do perfil; o mem_budget.py do firmware dá o valor exato
+#define TAM_TCP_PCB         164
+#define TAM_TCP_SEG         20
+#define TAM_PBUF            16
+#define PBUF_POOL_BUFSIZE   (TCP_MSS + 40 + 14 + 2)
+#define RAM_LWIP_ESTIMADA   (MEM_SIZE + PBUF_POOL_SIZE * (TAM_PBUF + PBUF_POOL_BUFSIZE) + \
+                             MEMP_NUM_TCP_PCB * TAM_TCP_PCB + MEMP_NUM_TCP_SEG * TAM_TCP_SEG + \
+                             MEMP_NUM_PBUF * TAM_PBUF)
+
+// Uma escrita em trânsito. Sem TCP_WRITE_FLAG_COPY, como no lwIP, os bytes só são
+// lidos da memória da aplicação na confirmação, então um buffer reaproveitado cedo
+// demais aparece no log
+typedef struct
+{
+    uint64_t t_confirmacao;
+    size_t posicao; // no log da resposta
+    const void *referencia;
+    u16_t len;
+    u16_t heap;
+    u8_t segmentos;
+    u8_t pbufs;
+} em_voo_t;
+
+typedef struct conexao_t
+{
+    struct tcp_pcb pcb;
+    struct conexao_t *proxima; // conexões abertas
+    char *dados;
+    size_t tamanho;
+    size_t capacidade;
+    em_voo_t voo[TCP_SND_QUEUELEN];
+    int num_voo;
+    int pbufs_fila;
+    uint64_t t_pedido;
+    uint64_t t_ultimo_byte; // fim da transmissão do último byte
+    bool cliente_fechou;
+} conexao_t;
+
+// Recursos do lwIP em uso e os picos
+typedef struct
+{
+    uint32_t heap, segmentos, pbufs_ref, pcbs;
+} recursos_t;
+
+static recursos_t uso, pico;
+
+// Estatísticas da carga para o resumo
+static struct
+{
+    uint32_t pedidos, completos, sem_pcb, erros_http, err_mem;
+    uint64_t bytes, ocupado_us, ocupado_desde;
+    uint32_t *latencias_us;
+    uint32_t num_latencias, cap_latencias;
+} est;
+
+static uint32_t rtt_us;     // 0 e bps 0: enlace ideal, confirmação imediata
+static uint64_t bps;
+static uint64_t enlace_livre_us;
+static conexao_t *abertas;
+
+const ip_addr_t host_ip_addr_any = {0};
+static struct netif netif_replay = {{0x0200000a}}; // 10.0.0.2
+struct netif *netif_default = &netif_replay;
+
+static struct tcp_pcb *listener;
+static u32_t proxima_id = 1;
+
+// Formato do alvo de cada caminho; %u recebe o parâmetro do evento
+static const char *caminhos[] = {
+    [TRACE_HTTP_ROOT] = "/",
+    [TRACE_HTTP_HISTORY_CSV] = "/history?since=%u&fmt=csv",
+    [TRACE_HTTP_HISTORY_BIN] = "/history?since=%u&fmt=bin",
+    [TRACE_HTTP_ROOT_HISTORY] = "/",
+};
+
+// Pedido que o cliente manda em seguida na mesma conexão (keep-alive), sem esperar a
+// resposta do primeiro
+static const char *segundos_pedidos[] = {
+    [TRACE_HTTP_ROOT_HISTORY] = "/history?since=%u&fmt=csv",
+};
+
+char *ip4addr_ntoa(const ip4_addr_t *addr)
+{
+    static char texto[16];
+    u32_t a = addr->addr;
+    snprintf(texto, sizeof(texto), "%u.%u.%u.%u", a & 0xff, (a >> 8) & 0xff, (a >> 16) & 0xff, a >> 24);
+    return texto;
+}
+
+char *ipaddr_ntoa(const ip_addr_t *addr)
+{
+    return ip4addr_ntoa(addr);
+}
+
+// ----------------------------------------------------------------- pbuf
+
+u8_t pbuf_free(struct pbuf *p)
+{
+    u8_t n = 0;
+    while (p)
+    {
+        struct pbuf *prox = p->next;
+        free(p);
+        p = prox;
+        n++;
+    }
+    return n;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset)
+{
+    u16_t copiados = 0;
+    for (; p && copiados < len; p = p->next)
+    {
+        if (offset >= p->len)
+        {
+            offset -= p->len;
+            continue;
+        }
+        u16_t n = p->len - offset;
+        if (n > len - copiados)
+            n = len - copiados;
+        memcpy((char *)dataptr + copiados, (const char *)p->payload + offset, n);
+        copiados += n;
+        offset = 0;
+    }
+    return copiados;
+}
+
+static struct pbuf *pbuf_do_texto(const char *texto)
+{
+    size_t n = strlen(texto);
+    struct pbuf *p = malloc(sizeof(struct pbuf) + n);
+    p->next = NULL;
+    p->payload = p + 1;
+    p->tot_len = p->len = (u16_t)n;
+    memcpy(p->payload, texto, n);
+    return p;
+}
+
+// ----------------------------------------------------------------- TCP
+
+struct tcp_pcb *tcp_new(void)
+{
+    conexao_t *c = calloc(1, sizeof(conexao_t));
+    c->pcb.snd_buf = TCP_SND_BUF;
+    c->pcb.id = proxima_id++;
+    return &c->pcb;
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
+{
+    (void)pcb;
+    (void)ipaddr;
+    (void)port;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen(struct tcp_pcb *pcb)
+{
+    pcb->listening = true;
+    listener = pcb;
+    return pcb;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept)
+{
+    pcb->accept = accept;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg)
+{
+    pcb->callback_arg = arg;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv)
+{
+    pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent)
+{
+    pcb->sent = sent;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn errf)
+{
+    pcb->errf = errf;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval)
+{
+    pcb->poll = poll;
+    pcb->pollinterval = interval;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len)
+{
+    (void)pcb;
+    (void)len;
+}
+
+static void marcar_pico(void)
+{
+    if (uso.heap > pico.heap)
+        pico.heap = uso.heap;
+    if (uso.segmentos > pico.segmentos)
+        pico.segmentos = uso.segmentos;
+    if (uso.pbufs_ref > pico.pbufs_ref)
+        pico.pbufs_ref = uso.pbufs_ref;
+    if (uso.pcbs > pico.pcbs)
+        pico.pcbs = uso.pcbs;
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *data, u16_t len, u8_t apiflags)
+{
+    conexao_t *c = (conexao_t *)pcb;
+    if (pcb->closed)
+        return ERR_VAL;
+
+    // Copiado: um pbuf no heap por segmento. Sem cópia: pbuf de referência (pool
+    // MEMP_PBUF) para os dados e outro no heap só para os cabeçalhos
+    bool copia = apiflags & TCP_WRITE_FLAG_COPY;
+    u8_t segmentos = (u8_t)((len + TCP_MSS - 1) / TCP_MSS);
+    if (segmentos == 0)
+        segmentos = 1;
+    u16_t heap = (u16_t)((copia ? len : 0) + segmentos * HEAP_POR_SEGMENTO);
+    u8_t pbufs = copia ? segmentos : 2 * segmentos;
+    if (len > pcb->snd_buf || c->pbufs_fila + pbufs > TCP_SND_QUEUELEN ||
+        uso.heap + heap > MEM_SIZE || uso.segmentos + segmentos > MEMP_NUM_TCP_SEG ||
+        (!copia && uso.pbufs_ref + segmentos > MEMP_NUM_PBUF))
+    {
+        est.err_mem++;
+        return ERR_MEM;
+    }
+    uso.heap += heap;
+    uso.segmentos += segmentos;
+    if (!copia)
+        uso.pbufs_ref += segmentos;
+    marcar_pico();
+
+    if (c->tamanho + len > c->capacidade)
+    {
+        c->capacidade = (c->tamanho + len) * 2;
+        c->dados = realloc(c->dados, c->capacidade);
+    }
+    if (copia)
+        memcpy(c->dados + c->tamanho, data, len);
+
+    uint64_t agora = replay_now();
+    uint64_t t_fim = agora;
+    if (bps)
+    { // enlace compartilhado por todas as conexões
+        uint64_t inicio = enlace_livre_us > agora ? enlace_livre_us : agora;
+        t_fim = inicio + ((uint64_t)len + segmentos * FIO_POR_SEGMENTO) * 8000000u / bps;
+        enlace_livre_us = t_fim;
+    }
+    c->t_ultimo_byte = t_fim;
+    c->voo[c->num_voo++] = (em_voo_t){t_fim + rtt_us, c->tamanho, copia ? NULL : data, len, heap, segmentos, pbufs};
+    c->pbufs_fila += pbufs;
+    c->tamanho += len;
+    pcb->snd_buf -= len;
+    pcb->unacked += len;
+    return ERR_OK;
+}
+
+err_t tcp_output(struct tcp_pcb *pcb)
+{
+    (void)pcb;
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb)
+{
+    pcb->closed = true;
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb)
+{
+    pcb->closed = true;
+    pcb->recv = NULL;
+    pcb->sent = NULL;
+    pcb->poll = NULL;
+}
+
+// ----------------------------------------------------------------- injeção de pedidos
+
+// Confirma as escritas com confirmação até o instante t: os dados sem cópia são lidos
+// agora e os recursos voltam ao lwIP. Retorna os bytes confirmados.
+static u16_t confirmar_ate(conexao_t *c, uint64_t t)
+{
+    u32_t len = 0;
+    int n = 0;
+    for (; n < c->num_voo && c->voo[n].t_confirmacao <= t; n++)
+    {
+        em_voo_t *v = &c->voo[n];
+        if (v->referencia)
+        {
+            memcpy(c->dados + v->posicao, v->referencia, v->len);
+            uso.pbufs_ref -= v->segmentos;
+        }
+        uso.heap -= v->heap;
+        uso.segmentos -= v->segmentos;
+        c->pbufs_fila -= v->pbufs;
+        len += v->len;
+    }
+    c->num_voo -= n;
+    memmove(c->voo, c->voo + n, c->num_voo * sizeof(c->voo[0]));
+    c->pcb.unacked -= len;
+    c->pcb.snd_buf += (u16_t)len;
+    return (u16_t)len;
+}
+
+// Conduz a conexão até esperar pela rede ou terminar: o cliente recebe as confirmações
+// (tcp_sent), a fila vazia dá à aplicação um tcp_poll para continuar e, sem mais nada a
+// receber, o cliente fecha. Retorna true quando a troca acabou.
+static bool progredir(conexao_t *c)
+{
+    struct tcp_pcb *pcb = &c->pcb;
+    for (int rodada = 0; rodada < MAX_RODADAS; rodada++)
+    {
+        u16_t len = confirmar_ate(c, replay_now());
+        if (len && !pcb->closed && pcb->sent)
+        {
+            pcb->sent(pcb->callback_arg, pcb, len);
+            continue;
+        }
+        if (c->num_voo > 0)
+            return false; // espera as confirmações pelo relógio virtual
+        if (!pcb->closed && pcb->poll)
+        {
+            pcb->poll(pcb->callback_arg, pcb);
+            if (c->num_voo > 0)
+                continue;
+        }
+        if (c->cliente_fechou)
+            return true;
+        c->cliente_fechou = true;
+        if (!pcb->closed && pcb->recv)
+            pcb->recv(pcb->callback_arg, pcb, NULL, ERR_OK); // cliente encerra
+    }
+    return true;
+}
+
+static void registrar_latencia(uint32_t us)
+{
+    if (est.num_latencias == est.cap_latencias)
+    {
+        est.cap_latencias = est.cap_latencias ? est.cap_latencias * 2 : 256;
+        est.latencias_us = realloc(est.latencias_us, est.cap_latencias * sizeof(uint32_t));
+    }
+    est.latencias_us[est.num_latencias++] = us;
+}
+
+static void concluir(conexao_t *c)
+{
+    struct tcp_pcb *pcb = &c->pcb;
+    confirmar_ate(c, UINT64_MAX); // o que ainda estiver em trânsito entra no log
+    replay_log("http#%u %zu bytes%s", pcb->id, c->tamanho, pcb->closed ? "" : " (conexão não fechada)");
+    replay_log_data(c->dados ? c->dados : "", c->tamanho);
+
+    est.completos++;
+    est.bytes += c->tamanho;
+    if (c->tamanho < 12 || strncmp(c->dados, "HTTP/1.1 200", 12) != 0)
+        est.erros_http++;
+    else // último byte chega ao cliente meio RTT depois de sair da placa
+        registrar_latencia((uint32_t)(c->t_ultimo_byte + rtt_us / 2 - c->t_pedido));
+
+    for (conexao_t **p = &abertas; *p; p = &(*p)->proxima)
+        if (*p == c)
+        {
+            *p = c->proxima;
+            break;
+        }
+    if (--uso.pcbs == 0)
+        est.ocupado_us += replay_now() - est.ocupado_desde;
+    free(c->dados);
+    free(c);
+}
+
+static struct pbuf *pbuf_do_pedido(const char *formato, uint16_t param, char *caminho, size_t max)
+{
+    snprintf(caminho, max, formato, (unsigned)param);
+    char pedido[128];
+    snprintf(pedido, sizeof(pedido), "GET %s HTTP/1.1\r\nHost: pico\r\n\r\n", caminho);
+    return pbuf_do_texto(pedido);
+}
+
+void host_http_request(uint path, uint16_t param)
+{
+    const char *formato = path < sizeof(caminhos) / sizeof(caminhos[0]) && caminhos[path] ? caminhos[path] : "/";
+    char caminho[64];
+    struct pbuf *pedido = pbuf_do_pedido(formato, param, caminho, sizeof(caminho));
+
+    if (!listener || !listener->accept)
+    {
+        replay_log("http GET %s recusado", caminho);
+        pbuf_free(pedido);
+        return;
+    }
+    est.pedidos++;
+    if (uso.pcbs >= MEMP_NUM_TCP_PCB)
+    { // tcp_alloc falha e o SYN é descartado
+        est.sem_pcb++;
+        replay_log("http GET %s recusado (sem pcb livre)", caminho);
+        pbuf_free(pedido);
+        return;
+    }
+
+    struct tcp_pcb *pcb = tcp_new();
+    conexao_t *c = (conexao_t *)pcb;
+    replay_log("http#%u GET %s", pcb->id, caminho);
+    pcb->callback_arg = listener->callback_arg;
+    c->t_pedido = c->t_ultimo_byte = replay_now();
+    c->proxima = abertas;
+    abertas = c;
+    if (uso.pcbs++ == 0)
+        est.ocupado_desde = replay_now();
+    marcar_pico();
+
+    if (listener->accept(listener->callback_arg, pcb, ERR_OK) == ERR_OK && !pcb->closed && pcb->recv)
+        pcb->recv(pcb->callback_arg, pcb, pedido, ERR_OK);
+    else
+        pbuf_free(pedido);
+    if (path < sizeof(segundos_pedidos) / sizeof(segundos_pedidos[0]) && segundos_pedidos[path])
+    { // chega antes de qualquer confirmação: quem estiver com o recv do pcb recebe
+        pedido = pbuf_do_pedido(segundos_pedidos[path], param, caminho, sizeof(caminho));
+        replay_log("http#%u GET %s (mesma conexão)", pcb->id, caminho);
+        if (!pcb->closed && pcb->recv)
+            pcb->recv(pcb->callback_arg, pcb, pedido, ERR_OK);
+        else
+            pbuf_free(pedido);
+    }
+    if (progredir(c))
+        concluir(c);
+}
+
+// ----------------------------------------------------------------- enlace simulado
+
+void host_net_config(uint32_t rtt_ms, uint32_t kbps)
+{
+    rtt_us = rtt_ms * 1000u;
+    bps = (uint64_t)kbps * 1000u;
+}
+
+uint64_t host_net_next(void)
+{
+    uint64_t t = UINT64_MAX;
+    for (conexao_t *c = abertas; c; c = c->proxima)
+        if (c->num_voo > 0 && c->voo[0].t_confirmacao < t)
+            t = c->voo[0].t_confirmacao;
+    return t;
+}
+
+void host_net_fire(void)
+{
+    uint64_t agora = replay_now();
+    for (conexao_t *c = abertas; c; c = c->proxima)
+        if (c->num_voo > 0 && c->voo[0].t_confirmacao <= agora)
+        {
+            if (progredir(c))
+                concluir(c);
+            return;
+        }
+}
+
+static int comparar_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double percentil_ms(double p)
+{
+    if (!est.num_latencias)
+        return 0.0;
+    uint32_t i = (uint32_t)(p * (est.num_latencias - 1) + 0.5);
+    return est.latencias_us[i] / 1000.0;
+}
+
+void host_net_report(void)
+{
+    if (!est.pedidos)
+        return;
+    qsort(est.latencias_us, est.num_latencias, sizeof(uint32_t), comparar_u32);
+    uint64_t ocupado = est.ocupado_us + (uso.pcbs ? replay_now() - est.ocupado_desde : 0);
+    fprintf(stderr,
+            "rede: perfil=%s pedidos=%u completos=%u sem_pcb=%u erros_http=%u err_mem=%u bytes=%llu "
+            "vazao_kBps=%.1f lat_p50_ms=%.1f lat_p95_ms=%.1f lat_max_ms=%.1f "
+            "heap=%u/%u pcbs=%u/%u segs=%u/%u pbufs_ref=%u/%u ram_lwip_est=%u\n",
+            LWIP_PROFILE_NAME, est.pedidos, est.completos, est.sem_pcb, est.erros_http, est.err_mem,
+            (unsigned long long)est.bytes, ocupado ? est.bytes * 1000.0 / ocupado : 0.0,
+            percentil_ms(0.50), percentil_ms(0.95), percentil_ms(1.0),
+            pico.heap, MEM_SIZE, pico.pcbs, MEMP_NUM_TCP_PCB, pico.segmentos, MEMP_NUM_TCP_SEG,
+            pico.pbufs_ref, MEMP_NUM_PBUF, (unsigned)RAM_LWIP_ESTIMADA);
+}
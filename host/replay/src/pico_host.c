@@ -0,0 +1,402 @@
+// Implementação do subconjunto do Pico SDK sobre o relógio virtual do replay.
+// Entradas (GPIO/ADC) vêm do trace; mudanças nas saídas viram linhas do log.
+
+#include <string.h>
+#include "replay.h"
+
+#define NUM_PINS   30
+#define NUM_SLICES 8
+#define NUM_ADC    5
+#define NP_MAX     (3 * 256) // bytes de um quadro NeoPixel
+#define MAX_TIMERS 8
+
+// Custo virtual de ler o relógio: faz laços de espera ativa terminarem de forma determinística
+#define CUSTO_LEITURA_US 1
+// Um byte do quadro NeoPixel sai em 8 bits a 800 kHz; o put bloqueia enquanto a FIFO esvazia
+#define CUSTO_PIO_BYTE_US 10
+
+typedef struct
+{
+    bool entrada;
+    bool nivel;
+    uint32_t irq_eventos;
+} pino_t;
+
+typedef struct
+{
+    uint32_t div16;
+    uint32_t top;
+    uint16_t nivel[2];
+    bool habilitado;
+} slice_t;
+
+struct host_pio
+{
+    uint8_t quadro[NP_MAX];
+    uint32_t tamanho;
+    bool programa;
+};
+static struct host_pio pios[2];
+struct host_pio *const host_pio_inst[2] = {&pios[0], &pios[1]};
+
+static pino_t pinos[NUM_PINS];
+static slice_t slices[NUM_SLICES];
+static gpio_irq_callback_t irq_callback;
+static uint16_t adc_valor[NUM_ADC] = {2048, 2048, 2048, 2048, 876}; // 876 ~ 27 °C no sensor interno
+static uint adc_entrada;
+static repeating_timer_t *timers[MAX_TIMERS];
+static watchdog_hw_t watchdog_regs;
+watchdog_hw_t *const watchdog_hw = &watchdog_regs;
+static uint64_t watchdog_periodo_us, watchdog_prazo_us = UINT64_MAX;
+
+// ----------------------------------------------------------------- tempo
+
+absolute_time_t get_absolute_time(void)
+{
+    replay_advance_to(replay_now() + CUSTO_LEITURA_US);
+    return replay_now();
+}
+
+uint64_t time_us_64(void)
+{
+    return get_absolute_time();
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)get_absolute_time();
+}
+
+void sleep_us(uint64_t us)
+{
+    // O reset (>50 us em nível baixo) fecha o quadro enviado à matriz
+    host_pio_flush();
+    replay_advance_to(replay_now() + us);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000);
+}
+
+void sleep_until(absolute_time_t t)
+{
+    host_pio_flush();
+    replay_advance_to(t);
+}
+
+// ----------------------------------------------------------------- watchdog
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug)
+{
+    (void)pause_on_debug;
+    watchdog_periodo_us = (uint64_t)delay_ms * 1000;
+    watchdog_prazo_us = replay_now() + watchdog_periodo_us;
+}
+
+void watchdog_update(void)
+{
+    if (watchdog_periodo_us)
+        watchdog_prazo_us = replay_now() + watchdog_periodo_us;
+}
+
+bool watchdog_caused_reboot(void)
+{
+    return false;
+}
+
+bool watchdog_enable_caused_reboot(void)
+{
+    return false;
+}
+
+// Na placa seria um reset; aqui registra os scratch e desarma (a aplicação segue rodando)
+static void watchdog_vencer(void)
+{
+    replay_log("watchdog reset scratch=%08x %08x %08x %08x", watchdog_regs.scratch[0], watchdog_regs.scratch[1],
+               watchdog_regs.scratch[2], watchdog_regs.scratch[3]);
+    watchdog_periodo_us = 0;
+    watchdog_prazo_us = UINT64_MAX;
+}
+
+// ----------------------------------------------------------------- timers
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data, repeating_timer_t *out)
+{
+    for (int i = 0; i < MAX_TIMERS; i++)
+    {
+        if (timers[i] && timers[i]->ativo)
+            continue;
+        *out = (repeating_timer_t){delay_us, callback, user_data, 0, true};
+        out->proximo_us = replay_now() + (uint64_t)(delay_us < 0 ? -delay_us : delay_us);
+        timers[i] = out;
+        return true;
+    }
+    return false;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer)
+{
+    bool estava = timer->ativo;
+    timer->ativo = false;
+    return estava;
+}
+
+uint64_t host_timer_next(void)
+{
+    uint64_t t = watchdog_prazo_us;
+    for (int i = 0; i < MAX_TIMERS; i++)
+        if (timers[i] && timers[i]->ativo && timers[i]->proximo_us < t)
+            t = timers[i]->proximo_us;
+    return t;
+}
+
+void host_timer_fire(void)
+{
+    uint64_t agora = replay_now();
+    if (watchdog_prazo_us <= agora)
+    {
+        watchdog_vencer();
+        return;
+    }
+    for (int i = 0; i < MAX_TIMERS; i++)
+    {
+        repeating_timer_t *rt = timers[i];
+        if (!rt || !rt->ativo || rt->proximo_us > agora)
+            continue;
+        uint64_t periodo = (uint64_t)(rt->delay_us < 0 ? -rt->delay_us : rt->delay_us);
+        uint64_t inicio = rt->proximo_us;
+        if (!rt->callback(rt))
+            rt->ativo = false;
+        // delay negativo: período medido do início do callback; positivo: do fim
+        rt->proximo_us = (rt->delay_us < 0 ? inicio : replay_now()) + periodo;
+        return;
+    }
+}
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT;
+}
+
+uint32_t clock_get_hz(enum clock_index clk)
+{
+    (void)clk;
+    return 125000000;
+}
+
+// ----------------------------------------------------------------- GPIO
+
+void gpio_init(uint gpio)
+{
+    if (gpio < NUM_PINS)
+        pinos[gpio] = (pino_t){true, false, 0};
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    if (gpio < NUM_PINS)
+        pinos[gpio].entrada = !out;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    if (gpio < NUM_PINS)
+        pinos[gpio].nivel = true;
+}
+
+void gpio_pull_down(uint gpio)
+{
+    if (gpio < NUM_PINS)
+        pinos[gpio].nivel = false;
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpio < NUM_PINS && pinos[gpio].nivel;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    if (gpio >= NUM_PINS || pinos[gpio].nivel == value)
+        return;
+    pinos[gpio].nivel = value;
+    replay_log("gpio %u=%d", gpio, value);
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled)
+{
+    if (gpio >= NUM_PINS)
+        return;
+    if (enabled)
+        pinos[gpio].irq_eventos |= events;
+    else
+        pinos[gpio].irq_eventos &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(gpio, events, enabled);
+    irq_callback = callback;
+}
+
+void host_gpio_input(uint pin, bool level)
+{
+    if (pin >= NUM_PINS || pinos[pin].nivel == level)
+        return;
+    pinos[pin].nivel = level;
+    uint32_t borda = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if (irq_callback && (pinos[pin].irq_eventos & borda))
+        irq_callback(pin, borda);
+}
+
+// ----------------------------------------------------------------- PWM
+
+pwm_config pwm_get_default_config(void)
+{
+    return (pwm_config){1 << 4, 0xffff};
+}
+
+static void pwm_log_config(uint slice)
+{
+    replay_log("pwm %u div=%u.%u top=%u", slice, slices[slice].div16 >> 4, slices[slice].div16 & 0xf, slices[slice].top);
+}
+
+void pwm_init(uint slice, pwm_config *c, bool start)
+{
+    if (slice >= NUM_SLICES)
+        return;
+    if (slices[slice].div16 != c->div16 || slices[slice].top != c->top)
+    {
+        slices[slice].div16 = c->div16;
+        slices[slice].top = c->top;
+        pwm_log_config(slice);
+    }
+    pwm_set_enabled(slice, start);
+}
+
+void pwm_set_clkdiv(uint slice, float divider)
+{
+    uint32_t div16 = (uint32_t)(divider * 16);
+    if (slice >= NUM_SLICES || slices[slice].div16 == div16)
+        return;
+    slices[slice].div16 = div16;
+    pwm_log_config(slice);
+}
+
+void pwm_set_wrap(uint slice, uint16_t wrap)
+{
+    if (slice >= NUM_SLICES || slices[slice].top == wrap)
+        return;
+    slices[slice].top = wrap;
+    pwm_log_config(slice);
+}
+
+void pwm_set_chan_level(uint slice, uint chan, uint16_t level)
+{
+    if (slice >= NUM_SLICES || chan > 1 || slices[slice].nivel[chan] == level)
+        return;
+    slices[slice].nivel[chan] = level;
+    replay_log("pwm %u%c level=%u", slice, chan ? 'B' : 'A', level);
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level)
+{
+    pwm_set_chan_level(pwm_gpio_to_slice_num(gpio), pwm_gpio_to_channel(gpio), level);
+}
+
+void pwm_set_enabled(uint slice, bool enabled)
+{
+    if (slice >= NUM_SLICES || slices[slice].habilitado == enabled)
+        return;
+    slices[slice].habilitado = enabled;
+    replay_log("pwm %u %s", slice, enabled ? "on" : "off");
+}
+
+// ----------------------------------------------------------------- PIO
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    (void)program;
+    pio->programa = true;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    (void)pio;
+    (void)required;
+    return 0;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    (void)sm;
+    if (pio->tamanho < NP_MAX)
+        pio->quadro[pio->tamanho++] = (uint8_t)data;
+    replay_advance_to(replay_now() + CUSTO_PIO_BYTE_US);
+}
+
+void host_pio_flush(void)
+{
+    static const char hex[] = "0123456789abcdef";
+    for (int i = 0; i < 2; i++)
+    {
+        struct host_pio *pio = &pios[i];
+        if (pio->tamanho == 0)
+            continue;
+        char linha[2 * NP_MAX + 1];
+        for (uint32_t j = 0; j < pio->tamanho; j++)
+        {
+            linha[2 * j] = hex[pio->quadro[j] >> 4];
+            linha[2 * j + 1] = hex[pio->quadro[j] & 0xf];
+        }
+        linha[2 * pio->tamanho] = '\0';
+        replay_log("np%d %s", i, linha);
+        pio->tamanho = 0;
+    }
+}
+
+// ----------------------------------------------------------------- ADC
+
+void adc_init(void)
+{
+}
+
+void adc_gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+void adc_set_temp_sensor_enabled(bool enable)
+{
+    (void)enable;
+}
+
+void adc_select_input(uint input)
+{
+    adc_entrada = input < NUM_ADC ? input : 0;
+}
+
+uint16_t adc_read(void)
+{
+    return adc_valor[adc_entrada];
+}
+
+void host_adc_input(uint input, uint16_t raw)
+{
+    if (input < NUM_ADC)
+        adc_valor[input] = raw & 0x0fff;
+}
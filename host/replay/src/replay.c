@@ -0,0 +1,259 @@
+// Motor de replay: carrega um trace, roda a aplicação sobre o relógio virtual e
+// registra as saídas (PWM, GPIO, quadros NeoPixel, respostas HTTP) em texto comparável
+// com diff. Sem -x o tempo virtual corre o mais rápido possível.
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "replay.h"
+#include "trace_fmt.h"
+
+typedef struct
+{
+    uint64_t t_us; // instante absoluto
+    uint8_t type;
+    uint8_t channel;
+    uint16_t value;
+} replay_event_t;
+
+static replay_event_t *eventos;
+static uint32_t num_eventos;
+static uint32_t proximo;      // índice do próximo evento a entregar
+static uint64_t agora_us;     // relógio virtual
+static uint64_t fim_us;       // instante em que o replay termina
+static double fator = 0.0;    // aceleração em relação ao tempo real (0 = sem limite)
+static bool despachando = false;
+static FILE *saida;
+static struct timespec inicio_real;
+
+static double segundos_reais(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec - inicio_real.tv_sec) + (ts.tv_nsec - inicio_real.tv_nsec) * 1e-9;
+}
+
+uint64_t replay_now(void)
+{
+    return agora_us;
+}
+
+void replay_log(const char *fmt, ...)
+{
+    va_list ap;
+    fprintf(saida, "%llu.%06llu ", (unsigned long long)(agora_us / 1000000), (unsigned long long)(agora_us % 1000000));
+    va_start(ap, fmt);
+    vfprintf(saida, fmt, ap);
+    va_end(ap);
+    fputc('\n', saida);
+}
+
+// Texto vai como está; corpos binários viram linhas de hexadecimal
+void replay_log_data(const char *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)data[i];
+        if (c < 0x20 && c != '\r' && c != '\n' && c != '\t')
+        {
+            for (size_t j = 0; j < len; j++)
+                fprintf(saida, "%02x%s", (unsigned char)data[j], (j % 32 == 31 || j == len - 1) ? "\n" : "");
+            return;
+        }
+    }
+    fwrite(data, 1, len, saida);
+    if (len == 0 || data[len - 1] != '\n')
+        fputc('\n', saida);
+}
+
+static void finalizar(void)
+{
+    host_pio_flush();
+    fflush(saida);
+    host_net_report();
+    double real = segundos_reais();
+    fprintf(stderr, "replay: %u eventos, %.1f s virtuais em %.3f s reais (%.0fx)\n",
+            num_eventos, agora_us / 1e6, real, real > 0 ? agora_us / 1e6 / real : 0.0);
+    exit(0);
+}
+
+static void entregar(const replay_event_t *ev)
+{
+    switch (ev->type)
+    {
+    case TRACE_EV_GPIO:
+        host_gpio_input(ev->channel, ev->value != 0);
+        break;
+    case TRACE_EV_ADC:
+        host_adc_input(ev->channel, ev->value);
+        break;
+    case TRACE_EV_HTTP:
+        host_http_request(ev->channel, ev->value);
+        break;
+    default:
+        break;
+    }
+}
+
+// Com -x, segura a simulação para não passar de 'fator' vezes o tempo real
+static void cadenciar(void)
+{
+    if (fator <= 0.0)
+        return;
+    double atraso = agora_us / 1e6 / fator - segundos_reais();
+    if (atraso > 0)
+    {
+        struct timespec ts = {(time_t)atraso, (long)((atraso - (time_t)atraso) * 1e9)};
+        while (nanosleep(&ts, &ts) && errno == EINTR)
+            ;
+    }
+}
+
+void replay_advance_to(uint64_t t)
+{
+    if (t < agora_us)
+        return;
+    if (t > fim_us)
+        t = fim_us;
+    // Dentro de um callback a aplicação está "em interrupção": o tempo corre, mas
+    // novos eventos e timers só são entregues quando ela voltar ao código principal.
+    if (!despachando)
+    {
+        despachando = true;
+        for (;;)
+        {
+            uint64_t t_evento = proximo < num_eventos ? eventos[proximo].t_us : UINT64_MAX;
+            uint64_t t_timer = host_timer_next();
+            uint64_t t_rede = host_net_next();
+            uint64_t t_prox = t_evento < t_timer ? t_evento : t_timer;
+            if (t_rede < t_prox)
+                t_prox = t_rede;
+            if (t_prox > t)
+                break;
+            if (t_prox > agora_us)
+                agora_us = t_prox;
+            if (t_rede == t_prox)
+                host_net_fire();
+            else if (t_evento <= t_timer)
+                entregar(&eventos[proximo++]);
+            else
+                host_timer_fire();
+        }
+        despachando = false;
+    }
+    if (t > agora_us)
+        agora_us = t;
+    cadenciar();
+    if (agora_us >= fim_us && !despachando)
+        finalizar();
+}
+
+static int carregar_trace(const char *caminho)
+{
+    FILE *f = fopen(caminho, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "replay: não foi possível abrir %s: %s\n", caminho, strerror(errno));
+        return -1;
+    }
+    trace_header_t header;
+    if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_MAGIC || header.version != TRACE_VERSION)
+    {
+        fprintf(stderr, "replay: %s não é um trace válido\n", caminho);
+        fclose(f);
+        return -1;
+    }
+    if (header.flags & TRACE_FLAG_OVERFLOW)
+        fprintf(stderr, "replay: aviso: o gravador descartou eventos neste trace\n");
+
+    eventos = calloc(header.count ? header.count : 1, sizeof(*eventos));
+    uint64_t t = 0;
+    trace_event_t ev;
+    while (num_eventos < header.count && fread(&ev, sizeof(ev), 1, f) == 1)
+    {
+        t += ev.dt_us;
+        eventos[num_eventos++] = (replay_event_t){t, ev.type, ev.channel, ev.value};
+    }
+    fclose(f);
+    if (num_eventos != header.count)
+        fprintf(stderr, "replay: aviso: trace truncado (%u de %u eventos)\n", num_eventos, header.count);
+    return 0;
+}
+
+static void uso(const char *prog)
+{
+    fprintf(stderr,
+            "uso: %s -i trace.bin [-o saida.txt] [-x fator] [-t cauda_s] [-d duracao_s] [-l rtt_ms:kbps] [-v]\n"
+            "  -x  aceleração em relação ao tempo real (padrão: o mais rápido possível)\n"
+            "  -t  tempo simulado após o último evento (padrão: 30 s)\n"
+            "  -d  duração máxima simulada\n"
+            "  -l  enlace com RTT e banda fixos para as respostas HTTP (padrão: ideal)\n"
+            "  -v  mostra o printf da aplicação em stderr\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *entrada = NULL, *arquivo_saida = NULL;
+    double cauda_s = 30.0, duracao_s = 0.0;
+    bool verbose = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:x:t:d:l:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i': entrada = optarg; break;
+        case 'o': arquivo_saida = optarg; break;
+        case 'x': fator = atof(optarg); break;
+        case 't': cauda_s = atof(optarg); break;
+        case 'd': duracao_s = atof(optarg); break;
+        case 'l':
+        {
+            unsigned rtt_ms = 0, kbps = 0;
+            if (sscanf(optarg, "%u:%u", &rtt_ms, &kbps) != 2 || kbps == 0)
+            {
+                uso(argv[0]);
+                return 2;
+            }
+            host_net_config(rtt_ms, kbps);
+            break;
+        }
+        case 'v': verbose = true; break;
+        default: uso(argv[0]); return 2;
+        }
+    }
+    if (!entrada)
+    {
+        uso(argv[0]);
+        return 2;
+    }
+    if (carregar_trace(entrada) != 0)
+        return 1;
+
+    // O log de saídas usa um descritor próprio; o stdout da aplicação vai para stderr
+    // (-v) ou é descartado, para não misturar com o que vai ser comparado.
+    saida = arquivo_saida ? fopen(arquivo_saida, "w") : fdopen(dup(STDOUT_FILENO), "w");
+    if (!saida)
+    {
+        fprintf(stderr, "replay: não foi possível criar a saída\n");
+        return 1;
+    }
+    if (verbose)
+        dup2(STDERR_FILENO, STDOUT_FILENO);
+    else if (!freopen("/dev/null", "w", stdout))
+        return 1;
+
+    uint64_t ultimo = num_eventos ? eventos[num_eventos - 1].t_us : 0;
+    fim_us = ultimo + (uint64_t)(cauda_s * 1e6);
+    if (duracao_s > 0 && (uint64_t)(duracao_s * 1e6) < fim_us)
+        fim_us = (uint64_t)(duracao_s * 1e6);
+
+    clock_gettime(CLOCK_MONOTONIC, &inicio_real);
+    app_main();
+    finalizar();
+    return 0;
+}
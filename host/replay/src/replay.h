@@ -0,0 +1,46 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// Interface interna do motor de replay (relógio virtual + despacho de eventos do trace)
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "host_sdk.h"
+
+// Relógio virtual em microssegundos desde o "boot"
+uint64_t replay_now(void);
+
+// Avança o relógio até t, entregando à aplicação os eventos do trace que vencerem
+void replay_advance_to(uint64_t t);
+
+// Escreve uma linha no log de saídas, prefixada pelo instante virtual
+void replay_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// Escreve um bloco de bytes no log (corpo de respostas HTTP)
+void replay_log_data(const char *data, size_t len);
+
+// Entradas vindas do trace (pico_host.c e lwip_host.c)
+void host_gpio_input(uint pin, bool level);
+void host_adc_input(uint input, uint16_t raw);
+void host_http_request(uint path, uint16_t param);
+
+// Timers repetitivos (pico_host.c): instante do próximo disparo (UINT64_MAX se nenhum)
+// e disparo do timer vencido no instante atual
+uint64_t host_timer_next(void);
+void host_timer_fire(void);
+
+// Enlace simulado (lwip_host.c): RTT e banda (0 e 0 = confirmação imediata), instante
+// da próxima confirmação em trânsito (UINT64_MAX se nenhuma), entrega das vencidas e
+// resumo da carga HTTP em stderr
+void host_net_config(uint32_t rtt_ms, uint32_t kbps);
+uint64_t host_net_next(void);
+void host_net_fire(void);
+void host_net_report(void);
+
+// Fecha o quadro NeoPixel pendente (chamado pelo reset de sleep_us e no fim)
+void host_pio_flush(void);
+
+// Ponto de entrada da aplicação (main renomeado na compilação)
+int app_main(void);
+
+#endif // REPLAY_H
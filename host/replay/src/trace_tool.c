@@ -0,0 +1,402 @@
+// Ferramenta de traces para o replay:
+//   trace_tool gen -a semaforo|botoes|joystick|unificado [-d segundos] [-s semente] [-r periodo_http_s]
+//                  [-c clientes] [-H periodo_historico_s] [-k periodo_keepalive_s] [-p intervalo_botoes_s]
+//                  -o trace.bin
+//   trace_tool import [-n gravacao] -o trace.bin < log_uart.txt
+//   trace_tool dump trace.bin
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace_fmt.h"
+
+typedef struct
+{
+    uint64_t t_us;
+    uint8_t type;
+    uint8_t channel;
+    uint16_t value;
+} evento_t;
+
+static evento_t *eventos;
+static size_t num_eventos, capacidade;
+
+static void adicionar(uint64_t t_us, uint8_t type, uint8_t channel, uint16_t value)
+{
+    if (num_eventos == capacidade)
+    {
+        capacidade = capacidade ? capacidade * 2 : 1024;
+        eventos = realloc(eventos, capacidade * sizeof(*eventos));
+    }
+    eventos[num_eventos++] = (evento_t){t_us, type, channel, value};
+}
+
+static int comparar(const void *a, const void *b)
+{
+    const evento_t *x = a, *y = b;
+    if (x->t_us != y->t_us)
+        return x->t_us < y->t_us ? -1 : 1;
+    return x < y ? -1 : 1; // mantém a ordem de inserção (qsort não é estável)
+}
+
+// xorshift64*: mesmo trace em qualquer plataforma para a mesma semente
+static uint64_t estado_rng = 88172645463325252ull;
+
+static uint32_t aleatorio(void)
+{
+    estado_rng ^= estado_rng >> 12;
+    estado_rng ^= estado_rng << 25;
+    estado_rng ^= estado_rng >> 27;
+    return (uint32_t)((estado_rng * 2685821657736338717ull) >> 32);
+}
+
+static uint32_t entre(uint32_t min, uint32_t max)
+{
+    return min + aleatorio() % (max - min + 1);
+}
+
+// Aperto de botão com pull-up: borda de descida, repiques opcionais e soltura
+static void aperto(uint64_t t, uint8_t pino)
+{
+    adicionar(t, TRACE_EV_GPIO, pino, 0);
+    if (aleatorio() % 4 == 0)
+    { // repique mecânico
+        adicionar(t + entre(200, 2000), TRACE_EV_GPIO, pino, 1);
+        adicionar(t + entre(2100, 4000), TRACE_EV_GPIO, pino, 0);
+    }
+    adicionar(t + entre(80, 400) * 1000ull, TRACE_EV_GPIO, pino, 1);
+}
+
+// Intervalo médio entre apertos de cada botão (-p); 0 = sem apertos, negativo = padrão da aplicação
+static int intervalo_botoes_s = -1;
+
+static void gerar_botoes(uint64_t dur, const uint8_t *pinos, int n, uint32_t intervalo_medio_s)
+{
+    if (intervalo_botoes_s >= 0)
+        intervalo_medio_s = (uint32_t)intervalo_botoes_s;
+    if (intervalo_medio_s == 0)
+        return;
+    for (int i = 0; i < n; i++)
+        for (uint64_t t = entre(1, intervalo_medio_s) * 1000000ull; t < dur; t += entre(2, 2 * intervalo_medio_s) * 1000000ull)
+            aperto(t, pinos[i]);
+}
+
+// Pedidos de "/": a cada período, 'clientes' painéis abertos pedem a página juntos
+static void gerar_http(uint64_t dur, uint32_t periodo_s, uint32_t clientes)
+{
+    if (periodo_s == 0)
+        return;
+    for (uint64_t t = 2000000; t < dur; t += periodo_s * 1000000ull + entre(0, 200000))
+        for (uint32_t i = 0; i < clientes; i++)
+            adicionar(t + i * 500ull, TRACE_EV_HTTP, TRACE_HTTP_ROOT, 0); // chegadas a 0,5 ms
+}
+
+// Pedidos do histórico completo (since=0), alternando CSV e binário
+static void gerar_historico(uint64_t dur, uint32_t periodo_s)
+{
+    if (periodo_s == 0)
+        return;
+    int n = 0;
+    for (uint64_t t = periodo_s * 1000000ull; t < dur; t += periodo_s * 1000000ull, n++)
+        adicionar(t + 500000, TRACE_EV_HTTP, n % 2 ? TRACE_HTTP_HISTORY_BIN : TRACE_HTTP_HISTORY_CSV, 0);
+}
+
+// Período dos pares "/" + "/history" na mesma conexão (-k); 0 = nenhum
+static uint32_t periodo_keepalive_s = 0;
+
+// Cliente keep-alive que pede o histórico logo depois da página, sem esperar a resposta
+static void gerar_keepalive(uint64_t dur)
+{
+    if (periodo_keepalive_s == 0)
+        return;
+    for (uint64_t t = periodo_keepalive_s * 1000000ull; t < dur; t += periodo_keepalive_s * 1000000ull)
+        adicionar(t + 250000, TRACE_EV_HTTP, TRACE_HTTP_ROOT_HISTORY, 0);
+}
+
+// Sensor de temperatura: deriva lenta em torno de ~27 °C com ruído de 2 LSB
+static void gerar_temperatura(uint64_t dur)
+{
+    int base = 876;
+    for (uint64_t t = 0; t < dur; t += 1000000)
+    {
+        if (aleatorio() % 60 == 0)
+            base += (int)entre(0, 2) - 1;
+        adicionar(t, TRACE_EV_ADC, 4, (uint16_t)(base + (int)entre(0, 4) - 2));
+    }
+}
+
+// Joystick: períodos parado no centro alternados com movimentos até um alvo
+static void gerar_joystick(uint64_t dur)
+{
+    int x = 2048, y = 2048, alvo_x = 2048, alvo_y = 2048;
+    for (uint64_t t = 0; t < dur; t += 100000)
+    {
+        if (aleatorio() % 20 == 0)
+        {
+            bool centro = aleatorio() % 2;
+            alvo_x = centro ? 2048 : (int)entre(0, 4095);
+            alvo_y = centro ? 2048 : (int)entre(0, 4095);
+        }
+        x += (alvo_x - x) / 2;
+        y += (alvo_y - y) / 2;
+        adicionar(t, TRACE_EV_ADC, 1, (uint16_t)(x + (int)entre(0, 16) - 8) & 0x0fff);
+        adicionar(t, TRACE_EV_ADC, 0, (uint16_t)(y + (int)entre(0, 16) - 8) & 0x0fff);
+    }
+}
+
+static void gerar(const char *app, uint64_t dur, uint32_t periodo_http_s, uint32_t clientes, uint32_t periodo_hist_s)
+{
+    if (strcmp(app, "semaforo") == 0)
+    {
+        static const uint8_t pinos[] = {5, 6};
+        gerar_botoes(dur, pinos, 2, 90);
+    }
+    else if (strcmp(app, "botoes") == 0)
+    {
+        static const uint8_t pinos[] = {5, 6};
+        gerar_botoes(dur, pinos, 2, 30);
+        gerar_temperatura(dur);
+        gerar_http(dur, periodo_http_s, clientes);
+        gerar_historico(dur, periodo_hist_s);
+        gerar_keepalive(dur);
+    }
+    else if (strcmp(app, "joystick") == 0)
+    {
+        static const uint8_t pinos[] = {22};
+        gerar_botoes(dur, pinos, 1, 45);
+        gerar_joystick(dur);
+        gerar_http(dur, periodo_http_s, clientes);
+        gerar_historico(dur, periodo_hist_s);
+        gerar_keepalive(dur);
+    }
+    else
+    { // firmware unificado: entradas das três aplicações no mesmo trace
+        static const uint8_t pinos[] = {5, 6, 22};
+        gerar_botoes(dur, pinos, 3, 45);
+        gerar_temperatura(dur);
+        gerar_joystick(dur);
+        gerar_http(dur, periodo_http_s, clientes);
+        gerar_historico(dur, periodo_hist_s);
+        gerar_keepalive(dur);
+    }
+}
+
+static int gravar(const char *caminho, uint16_t flags)
+{
+    FILE *f = fopen(caminho, "wb");
+    if (!f)
+    {
+        perror(caminho);
+        return 1;
+    }
+    qsort(eventos, num_eventos, sizeof(*eventos), comparar);
+
+    // Conta os SKIPs necessários antes de escrever o cabeçalho
+    uint32_t total = 0;
+    uint64_t anterior = 0;
+    for (size_t i = 0; i < num_eventos; i++)
+    {
+        total += 1 + (uint32_t)((eventos[i].t_us - anterior) / UINT32_MAX);
+        anterior = eventos[i].t_us;
+    }
+    trace_header_t header = {TRACE_MAGIC, TRACE_VERSION, flags, total, 0};
+    fwrite(&header, sizeof(header), 1, f);
+
+    anterior = 0;
+    for (size_t i = 0; i < num_eventos; i++)
+    {
+        uint64_t dt = eventos[i].t_us - anterior;
+        for (; dt > UINT32_MAX; dt -= UINT32_MAX)
+        {
+            trace_event_t skip = {UINT32_MAX, TRACE_EV_SKIP, 0, 0};
+            fwrite(&skip, sizeof(skip), 1, f);
+        }
+        trace_event_t ev = {(uint32_t)dt, eventos[i].type, eventos[i].channel, eventos[i].value};
+        fwrite(&ev, sizeof(ev), 1, f);
+        anterior = eventos[i].t_us;
+    }
+    fclose(f);
+    fprintf(stderr, "trace_tool: %u eventos em %s\n", total, caminho);
+    return 0;
+}
+
+// Converte as linhas "#TRC <hex>" despejadas pela placa (trace_rec.c) em binário. Cada
+// gravação sai em vários blocos; os marcados com TRACE_FLAG_CONTINUATION são emendados
+// ao anterior, e 'trace_desejado' conta só as gravações (o bloco que não continua nada).
+static int importar(FILE *entrada, const char *caminho, int trace_desejado)
+{
+    char linha[512];
+    int trace = -1;
+    bool dentro = false, achou = false;
+    uint8_t *bloco = NULL;
+    size_t tamanho = 0, capacidade_bloco = 0;
+    trace_event_t *saida = NULL;
+    uint32_t total = 0, blocos = 0, proxima_sequencia = 0;
+    uint16_t flags = 0;
+    while (fgets(linha, sizeof(linha), entrada))
+    {
+        if (strncmp(linha, "#TRC-BEGIN", 10) == 0)
+        {
+            dentro = true;
+            tamanho = 0;
+        }
+        else if (dentro && strncmp(linha, "#TRC ", 5) == 0)
+        {
+            for (char *p = linha + 5; p[0] && p[1] && p[0] != '\n' && p[0] != '\r'; p += 2)
+            {
+                unsigned byte;
+                if (sscanf(p, "%2x", &byte) != 1)
+                    break;
+                if (tamanho == capacidade_bloco)
+                {
+                    capacidade_bloco = capacidade_bloco ? capacidade_bloco * 2 : 4096;
+                    bloco = realloc(bloco, capacidade_bloco);
+                }
+                bloco[tamanho++] = (uint8_t)byte;
+            }
+        }
+        else if (dentro && strncmp(linha, "#TRC-END", 8) == 0)
+        {
+            dentro = false;
+            trace_header_t h;
+            if (tamanho < sizeof(h))
+                continue;
+            memcpy(&h, bloco, sizeof(h));
+            if (h.magic != TRACE_MAGIC)
+                continue;
+            bool continua = h.flags & TRACE_FLAG_CONTINUATION;
+            if (!continua || trace < 0) // um log que começa no meio da gravação conta como uma
+                trace++;
+            if (trace > trace_desejado)
+                break;
+            if (trace < trace_desejado)
+                continue;
+            if (achou && h.reserved != proxima_sequencia)
+                fprintf(stderr, "trace_tool: aviso: faltam os blocos %u a %u da gravação\n",
+                        proxima_sequencia, h.reserved - 1);
+            uint32_t n = h.count;
+            if (n > (tamanho - sizeof(h)) / sizeof(trace_event_t))
+            {
+                n = (uint32_t)((tamanho - sizeof(h)) / sizeof(trace_event_t));
+                fprintf(stderr, "trace_tool: aviso: bloco %u truncado (%u de %u eventos)\n", h.reserved, n, h.count);
+            }
+            saida = realloc(saida, (total + n + 1) * sizeof(*saida));
+            memcpy(saida + total, bloco + sizeof(h), n * sizeof(trace_event_t));
+            total += n;
+            flags |= h.flags & TRACE_FLAG_OVERFLOW;
+            proxima_sequencia = h.reserved + 1;
+            blocos++;
+            achou = true;
+        }
+    }
+    free(bloco);
+    if (!achou)
+    {
+        fprintf(stderr, "trace_tool: gravação %d não encontrada\n", trace_desejado);
+        free(saida);
+        return 1;
+    }
+    FILE *f = fopen(caminho, "wb");
+    if (!f)
+    {
+        perror(caminho);
+        free(saida);
+        return 1;
+    }
+    trace_header_t header = {TRACE_MAGIC, TRACE_VERSION, flags, total, 0};
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(saida, sizeof(*saida), total, f);
+    fclose(f);
+    free(saida);
+    fprintf(stderr, "trace_tool: %u eventos de %u blocos em %s\n", total, blocos, caminho);
+    return 0;
+}
+
+static int despejar(const char *caminho)
+{
+    FILE *f = fopen(caminho, "rb");
+    trace_header_t header;
+    if (!f || fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_MAGIC)
+    {
+        fprintf(stderr, "trace_tool: %s não é um trace válido\n", caminho);
+        return 1;
+    }
+    static const char *nomes[] = {"skip", "gpio", "adc", "http"};
+    printf("# versão %u, %u eventos, flags 0x%04x\n", header.version, header.count, header.flags);
+    uint64_t t = 0;
+    trace_event_t ev;
+    while (fread(&ev, sizeof(ev), 1, f) == 1)
+    {
+        t += ev.dt_us;
+        printf("%llu.%06llu %s %u %u\n", (unsigned long long)(t / 1000000), (unsigned long long)(t % 1000000),
+               ev.type < 4 ? nomes[ev.type] : "?", ev.channel, ev.value);
+    }
+    fclose(f);
+    return 0;
+}
+
+static void uso(void)
+{
+    fprintf(stderr,
+            "uso: trace_tool gen -a semaforo|botoes|joystick|unificado [-d segundos] [-s semente] [-r periodo_http_s]\n"
+            "                   [-c clientes] [-H periodo_historico_s] [-k periodo_keepalive_s]\n"
+            "                   [-p intervalo_botoes_s] -o trace.bin\n"
+            "     trace_tool import [-n gravacao] -o trace.bin < log_uart.txt\n"
+            "     trace_tool dump trace.bin\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        uso();
+        return 2;
+    }
+    const char *comando = argv[1];
+    if (strcmp(comando, "dump") == 0 && argc == 3)
+        return despejar(argv[2]);
+
+    const char *app = "semaforo", *saida = NULL;
+    double dur_s = 86400;
+    uint32_t periodo_http_s = 10, clientes = 1, periodo_hist_s = 0;
+    int bloco = 0, opt;
+    optind = 2;
+    while ((opt = getopt(argc, argv, "a:d:s:r:c:H:k:p:n:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': app = optarg; break;
+        case 'd': dur_s = atof(optarg); break;
+        case 's': estado_rng ^= strtoull(optarg, NULL, 0) * 0x9e3779b97f4a7c15ull; break;
+        case 'r': periodo_http_s = (uint32_t)atoi(optarg); break;
+        case 'c': clientes = (uint32_t)atoi(optarg); break;
+        case 'H': periodo_hist_s = (uint32_t)atoi(optarg); break;
+        case 'k': periodo_keepalive_s = (uint32_t)atoi(optarg); break;
+        case 'p': intervalo_botoes_s = atoi(optarg); break;
+        case 'n': bloco = atoi(optarg); break;
+        case 'o': saida = optarg; break;
+        default: uso(); return 2;
+        }
+    }
+    if (!saida)
+    {
+        uso();
+        return 2;
+    }
+    if (strcmp(comando, "gen") == 0)
+    {
+        if (strcmp(app, "semaforo") && strcmp(app, "botoes") && strcmp(app, "joystick") && strcmp(app, "unificado"))
+        {
+            uso();
+            return 2;
+        }
+        gerar(app, (uint64_t)(dur_s * 1e6), periodo_http_s, clientes, periodo_hist_s);
+        return gravar(saida, TRACE_FLAG_SYNTH);
+    }
+    if (strcmp(comando, "import") == 0)
+        return importar(stdin, saida, bloco);
+    uso();
+    return 2;
+}
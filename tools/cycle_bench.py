@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Benchmark de precisão das trocas de fase do semáforo no replay do host.
+
+Uso:
+    cycle_bench.py [--build-dir build-cycle-bench] [--ciclos 2000] [--semente 1] [--base REV]
+
+Compila host/replay, gera os traces com trace_tool e mede, no log de saídas do replay,
+o instante real de cada troca de fase (verde, amarelo, vermelho: níveis de PWM dos
+LEDs) contra o instante planejado. O replay cobra o tempo das ações como na placa
+(leituras do relógio e ~10 us por byte da matriz NeoPixel), então o que o firmware
+gasta entre as esperas aparece como deriva.
+
+Cenários:
+  livre         sem pedestres: o plano é fixo (ciclo de 18,6 s a partir do primeiro
+                verde), então o erro sai só do log, para qualquer versão do firmware
+  pedestres     apertos a cada ~90 s: o plano depende das entradas; vale o relatório
+                [CICLO] do próprio firmware (atraso de cada instante planejado)
+  sincronizado  replay_semaforo_sync: grade de 25 s no relógio de referência sintético
+                (+50 ppm em relação ao cristal, common/timesync/timesync_local.c); o
+                início de cada ciclo é comparado à grade na referência, depois da
+                primeira sincronização
+
+Com --base REV o cenário livre também roda no firmware da revisão REV (worktree
+temporária em build-dir/base-src), para comparar com a versão atual.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Plano sem pedestres (SemaforoComBotão/semaforo.c): verde 4 + 6 s, amarelo 3 s,
+# vermelho com bips (0,8 s) + 4 s + bip longo (0,8 s)
+CICLO_LIVRE_MS = 18600
+FRONTEIRAS_LIVRE = {'verde': 0, 'amarelo': 10000, 'vermelho': 13000}
+LIMITE_US = 10000  # coordenação em onda verde: erro de ciclo abaixo de 10 ms
+
+GRADE_SYNC_MS = 25000            # SEMAFORO_CICLO_MS de replay_semaforo_sync
+BASE_REF_US = 1700000000000000   # TIMESYNC_LOCAL_BASE_US
+PERIODO_SYNC_S = 60              # TIMESYNC_PERIODO_S
+
+RE_PWM = re.compile(r'^(\d+)\.(\d{6}) pwm (5B|6B) level=(\d+)$', re.M)
+RE_CICLO = re.compile(r'^\[CICLO\] .*$', re.M)
+RE_PPM = re.compile(r'referência local: ([+-]\d+) ppm')
+
+
+def rodar(cmd, **kw):
+    return subprocess.run(cmd, check=True, capture_output=True, text=True, **kw)
+
+
+def compilar(fonte, destino):
+    rodar(['cmake', '-S', os.path.join(fonte, 'host', 'replay'), '-B', destino, '-DCMAKE_BUILD_TYPE=Release'])
+    rodar(['cmake', '--build', destino, '-j', str(os.cpu_count() or 1)])
+    return destino
+
+
+def trocas(log):
+    """(instante_us, fase) de cada troca de fase no log, na ordem."""
+    saida = []
+    verde = vermelho = 0
+    for m in RE_PWM.finditer(log):
+        t = int(m.group(1)) * 1000000 + int(m.group(2))
+        nivel = int(m.group(4))
+        if m.group(3) == '5B':  # verde (slice 5)
+            if nivel and not verde and not vermelho:
+                saida.append((t, 'verde'))
+            elif not nivel and verde:
+                saida.append((t, 'vermelho'))
+            verde = nivel
+        else:  # vermelho (slice 6): aceso sozinho no vermelho, com o verde no amarelo
+            if nivel and verde:
+                saida.append((t, 'amarelo'))
+            vermelho = nivel
+    return saida
+
+
+def resumo(erros):
+    absolutos = [abs(e) for e in erros]
+    dentro = sum(1 for e in absolutos if e < LIMITE_US)
+    return (f'{len(erros):>7} {sum(absolutos) / len(absolutos):>10.0f} {max(absolutos):>10} '
+            f'{erros[-1]:>+11} {100.0 * dentro / len(erros):>7.2f}%')
+
+
+def replay(destino, app, trace, segundos, verbose=False):
+    cmd = [os.path.join(destino, app), '-i', trace, '-o', '/dev/stdout', '-t', str(segundos), '-d', str(segundos)]
+    if verbose:
+        cmd.append('-v')
+    return rodar(cmd)
+
+
+def livre(destino, trace, segundos):
+    fases = trocas(replay(destino, 'replay_semaforo', trace, segundos).stdout)
+    inicio = next(t for t, f in fases if f == 'verde')
+    erros, k = [], -1
+    for t, f in fases:
+        if t < inicio:
+            continue
+        if f == 'verde':
+            k += 1
+        erros.append(t - (inicio + (k * CICLO_LIVRE_MS + FRONTEIRAS_LIVRE[f]) * 1000))
+    return erros
+
+
+def sincronizado(destino, trace, segundos):
+    r = replay(destino, 'replay_semaforo_sync', trace, segundos, verbose=True)
+    ppm = int(RE_PPM.search(r.stderr).group(1))
+    grade = GRADE_SYNC_MS * 1000
+    erros = []
+    for t, f in trocas(r.stdout):
+        if f != 'verde' or t < 2 * PERIODO_SYNC_S * 1000000:
+            continue  # antes da primeira correção de frequência
+        ref = BASE_REF_US + t + t * ppm // 1000000
+        erros.append((ref + grade // 2) % grade - grade // 2)
+    return erros, ppm
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--build-dir', default='build-cycle-bench')
+    ap.add_argument('--ciclos', type=int, default=2000)
+    ap.add_argument('--semente', default='1')
+    ap.add_argument('--base', help='revisão do git para comparar no cenário livre')
+    args = ap.parse_args()
+
+    atual = compilar(REPO, os.path.join(args.build_dir, 'atual'))
+    trace_tool = os.path.join(atual, 'trace_tool')
+    segundos = args.ciclos * CICLO_LIVRE_MS // 1000 + 10
+    traces = {}
+    for nome, opcoes in (('livre', ['-p', '0']), ('pedestres', [])):
+        traces[nome] = os.path.join(args.build_dir, f'{nome}.bin')
+        rodar([trace_tool, 'gen', '-a', 'semaforo', '-d', str(segundos), '-s', args.semente] + opcoes
+              + ['-o', traces[nome]])
+
+    print(f'{args.ciclos} ciclos sem pedestres ({segundos} s simulados); erro = real - planejado')
+    print(f'{"cenário":<24} {"trocas":>7} {"med(us)":>10} {"pior(us)":>10} {"último(us)":>11} {"<10ms":>8}')
+    if args.base:
+        # Caminho fixo da worktree: o cache do CMake em build-dir/base continua válido
+        fonte = os.path.abspath(os.path.join(args.build_dir, 'base-src'))
+        rodar(['git', '-C', REPO, 'worktree', 'add', '--force', '--detach', fonte, args.base])
+        try:
+            base = compilar(fonte, os.path.join(args.build_dir, 'base'))
+            print(f'{"livre (" + args.base + ")":<24} {resumo(livre(base, traces["livre"], segundos))}')
+        finally:
+            rodar(['git', '-C', REPO, 'worktree', 'remove', '--force', fonte])
+    print(f'{"livre (atual)":<24} {resumo(livre(atual, traces["livre"], segundos))}')
+
+    erros, ppm = sincronizado(atual, traces['pedestres'], segundos)
+    if not erros:
+        sys.exit('replay_semaforo_sync não produziu ciclos depois da sincronização')
+    print(f'{"sincronizado (" + str(ppm) + " ppm)":<24} {resumo(erros)}')
+
+    r = replay(atual, 'replay_semaforo', traces['pedestres'], segundos, verbose=True)
+    linhas = RE_CICLO.findall(r.stderr)
+    if linhas:
+        print(f'pedestres (firmware): {linhas[-1]}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Relatório de posicionamento das funções críticas em tempo (HOT_PATH).
+
+Uso:
+    hot_report.py firmware.elf --symbols hot_symbols.txt [--strict]
+                  [--nm arm-none-eabi-nm] [--objdump arm-none-eabi-objdump]
+
+Para cada símbolo listado no arquivo, mostra se ele está na SRAM ou ainda na
+flash (executado via cache XIP). Para os que estão na SRAM, desmonta o corpo e
+lista as chamadas que saem para a flash (diretas ou por veneer do linker): cada
+uma é uma possível falta de cache dentro do caminho crítico. Chamadas indiretas
+(blx rN) são só contadas.
+
+Símbolos ausentes foram expandidos inline no chamador ou descartados pelo linker.
+Com --strict, sai com código 1 se algum símbolo listado estiver na flash.
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# Mapa de memória do RP2040
+REGIOES = [
+    (0x10000000, 0x14000000, 'flash'),  # XIP e seus apelidos (sem cache, etc.)
+    (0x20000000, 0x20042000, 'SRAM'),
+]
+
+RE_CHAMADA = re.compile(r'\sblx?\s+([0-9a-f]+)\s+<([^>+]+)(?:\+0x[0-9a-f]+)?>')
+RE_INDIRETA = re.compile(r'\sblx\s+r\d+')
+RE_VENEER = re.compile(r'^__(.+)_veneer$')
+
+
+def regiao(endereco):
+    for inicio, fim, nome in REGIOES:
+        if inicio <= endereco < fim:
+            return nome
+    return '?'
+
+
+def ler_simbolos(elf, nm):
+    """Retorna {nome: (endereço, tamanho)} das funções e objetos do ELF."""
+    saida = subprocess.run([nm, '-S', '--defined-only', elf],
+                           check=True, capture_output=True, text=True).stdout
+    simbolos = {}
+    for linha in saida.splitlines():
+        partes = linha.split()
+        if len(partes) == 4:
+            endereco, tamanho, _tipo, nome = partes
+            simbolos.setdefault(nome, (int(endereco, 16) & ~1, int(tamanho, 16)))
+        elif len(partes) == 3:
+            endereco, _tipo, nome = partes
+            simbolos.setdefault(nome, (int(endereco, 16) & ~1, 0))
+    return simbolos
+
+
+def chamadas_para_flash(elf, objdump, endereco, tamanho, simbolos):
+    """Retorna (nomes chamados na flash, número de chamadas indiretas)."""
+    if tamanho == 0:
+        return [], 0
+    saida = subprocess.run([objdump, '-D', f'--start-address={endereco:#x}',
+                            f'--stop-address={endereco + tamanho:#x}', elf],
+                           check=True, capture_output=True, text=True).stdout
+    flash, indiretas = [], 0
+    for linha in saida.splitlines():
+        if RE_INDIRETA.search(linha):
+            indiretas += 1
+            continue
+        m = RE_CHAMADA.search(linha)
+        if not m:
+            continue
+        alvo, nome = int(m.group(1), 16), m.group(2)
+        v = RE_VENEER.match(nome)
+        if v and v.group(1) in simbolos:  # ponte do linker: o destino real é outro
+            nome, alvo = v.group(1), simbolos[v.group(1)][0]
+        if regiao(alvo) == 'flash' and nome not in flash:
+            flash.append(nome)
+    return flash, indiretas
+
+
+def ler_lista(caminho):
+    with open(caminho) as f:
+        return [l.split('#', 1)[0].strip() for l in f if l.split('#', 1)[0].strip()]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('elf')
+    ap.add_argument('--symbols', required=True, help='arquivo com um símbolo crítico por linha')
+    ap.add_argument('--strict', action='store_true', help='falha se algum símbolo estiver na flash')
+    ap.add_argument('--nm', default='arm-none-eabi-nm')
+    ap.add_argument('--objdump', default='arm-none-eabi-objdump')
+    args = ap.parse_args()
+
+    simbolos = ler_simbolos(args.elf, args.nm)
+    na_flash = []
+    print(f'{"símbolo":<28} {"região":<6} {"endereço":>10} {"bytes":>6}  chamadas para a flash')
+    for nome in ler_lista(args.symbols):
+        if nome not in simbolos:
+            print(f'{nome:<28} {"-":<6} {"-":>10} {"-":>6}  (inline no chamador ou removido)')
+            continue
+        endereco, tamanho = simbolos[nome]
+        onde = regiao(endereco)
+        detalhe = ''
+        if onde == 'flash':
+            na_flash.append(nome)
+            detalhe = 'AINDA NA FLASH'
+        elif onde == 'SRAM':
+            flash, indiretas = chamadas_para_flash(args.elf, args.objdump, endereco, tamanho, simbolos)
+            detalhe = ', '.join(flash) if flash else '-'
+            if indiretas:
+                detalhe += f' (+{indiretas} indiretas)'
+        print(f'{nome:<28} {onde:<6} {endereco:#010x} {tamanho:6d}  {detalhe}')
+
+    if na_flash:
+        print(f'hot_report: {len(na_flash)} símbolo(s) crítico(s) na flash: {", ".join(na_flash)}')
+        if args.strict:
+            return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
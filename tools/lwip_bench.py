@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Matriz de benchmark dos perfis do lwIP (common/lwip/lwipopts.h) no replay do host.
+
+Uso:
+    lwip_bench.py [--build-dir build-lwip-bench] [--perfis generic,low_memory,...]
+                  [--rtt-ms 10] [--kbps 8000] [--duracao 120]
+
+Compila host/replay uma vez por perfil (-DLWIP_PROFILE=<perfil>), gera as cargas HTTP
+com trace_tool e roda cada uma com o enlace simulado (-l rtt:kbps). O modelo de rede
+aplica os limites do perfil (heap, pcbs, segmentos, pbufs de referência, fila por
+conexão), então ERR_MEM e conexões recusadas aparecem como na placa. Os números são
+do modelo do lwIP no host, não medidos na placa: servem para comparar os perfis entre
+si, não como valores absolutos do Pico W.
+
+Cargas:
+  paginas    8 painéis pedindo "/" juntos a cada segundo (botoes_webserver)
+  historico  /history?since=0 completo a cada 2 s, CSV e binário alternados
+  misto      4 painéis por segundo e histórico a cada 5 s (joystck_wifi_webserver)
+
+Colunas: pedidos respondidos com 200/total, recusados (sem pcb ou resposta != 200;
+os dois somados nunca passam do total, a diferença ficou aberta no fim), ERR_MEM
+vistos pela aplicação, vazão enquanto há conexão aberta, latência do pedido ao último
+byte no cliente (p50/p95/máx), pico do heap do lwIP e RAM estática estimada do perfil.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+PERFIS = ['generic', 'low_memory', 'many_small_connections', 'streaming_throughput']
+
+CARGAS = {
+    'paginas': ('botoes', ['-r', '1', '-c', '8']),
+    'historico': ('botoes', ['-r', '0', '-H', '2']),
+    'misto': ('joystick', ['-r', '1', '-c', '4', '-H', '5']),
+}
+
+RE_REDE = re.compile(r'^rede: (.*)$', re.M)
+REPO = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def rodar(cmd, **kw):
+    return subprocess.run(cmd, check=True, capture_output=True, text=True, **kw)
+
+
+def compilar(build_dir, perfil):
+    destino = os.path.join(build_dir, perfil)
+    rodar(['cmake', '-S', os.path.join(REPO, 'host', 'replay'), '-B', destino, f'-DLWIP_PROFILE={perfil}'])
+    rodar(['cmake', '--build', destino, '-j', str(os.cpu_count() or 1)])
+    return destino
+
+
+def medir(destino, app, trace, rtt_ms, kbps):
+    r = rodar([os.path.join(destino, f'replay_{app}'), '-i', trace, '-o', os.devnull, '-l', f'{rtt_ms}:{kbps}'])
+    m = RE_REDE.search(r.stderr)
+    if not m:
+        sys.exit(f'{destino}: replay_{app} não imprimiu o resumo da rede')
+    return dict(par.split('=', 1) for par in m.group(1).split())
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('--build-dir', default='build-lwip-bench')
+    ap.add_argument('--perfis', default=','.join(PERFIS))
+    ap.add_argument('--rtt-ms', type=int, default=10)
+    ap.add_argument('--kbps', type=int, default=8000)
+    ap.add_argument('--duracao', type=int, default=120, help='segundos simulados por carga')
+    args = ap.parse_args()
+
+    perfis = args.perfis.split(',')
+    destinos = {p: compilar(args.build_dir, p) for p in perfis}
+
+    # Mesmos traces para todos os perfis
+    trace_tool = os.path.join(destinos[perfis[0]], 'trace_tool')
+    traces = {}
+    for carga, (app, opcoes) in CARGAS.items():
+        traces[carga] = os.path.join(args.build_dir, f'{carga}.bin')
+        rodar([trace_tool, 'gen', '-a', app, '-d', str(args.duracao), '-s', '1'] + opcoes + ['-o', traces[carga]])
+
+    print('modelo do lwIP no host (host/replay), não medido na placa')
+    print(f'enlace: RTT {args.rtt_ms} ms, {args.kbps} kbit/s; {args.duracao} s por carga')
+    print(f'{"carga":<10} {"perfil":<23} {"200/total":>11} {"recus":>5} {"errmem":>6} {"kB/s":>7} '
+          f'{"p50 ms":>7} {"p95 ms":>7} {"máx ms":>7} {"heap pico":>13} {"RAM lwIP":>9}')
+    for carga, (app, _) in CARGAS.items():
+        for perfil in perfis:
+            r = medir(destinos[perfil], app, traces[carga], args.rtt_ms, args.kbps)
+            # O replay conta como completa toda conexão encerrada, inclusive com 503:
+            # aqui só as respostas 200 contam, e as outras entram nas recusas
+            ok = int(r['completos']) - int(r['erros_http'])
+            recusados = int(r['sem_pcb']) + int(r['erros_http'])
+            print(f'{carga:<10} {perfil:<23} {str(ok) + "/" + r["pedidos"]:>11} {recusados:5d} '
+                  f'{int(r["err_mem"]):6d} {float(r["vazao_kBps"]):7.1f} {float(r["lat_p50_ms"]):7.1f} '
+                  f'{float(r["lat_p95_ms"]):7.1f} {float(r["lat_max_ms"]):7.1f} {r["heap"]:>13} '
+                  f'{int(r["ram_lwip_est"]):9d}')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Tabela de orçamento de RAM/flash por módulo a partir do mapa de link (GNU ld).
+
+Uso:
+    mem_budget.py firmware.elf.map [--budget mem_budget.txt]
+
+Cada seção de entrada do mapa é atribuída a um módulo (arquivo da aplicação,
+biblioteca do SDK, lwIP, driver cyw43, libc...). Seções com endereço de carga
+em flash (.data, .scratch_*) contam nos dois orçamentos.
+
+Arquivo de orçamento: uma linha por módulo, "<módulo> <ram_max> <flash_max>",
+em bytes, '-' para sem limite; o módulo TOTAL limita a soma. Se algum limite
+for ultrapassado o script sai com código 1 e o build falha.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Seções de saída do script de link do RP2040 (memmap_default.ld)
+SECOES_FLASH = {'.boot2', '.text', '.rodata', '.ARM.extab', '.ARM.exidx',
+                '.binary_info_header', '.binary_info', '.flash_end'}
+SECOES_RAM = {'.ram_vector_table', '.uninitialized_data', '.data', '.bss', '.tbss', '.tdata',
+              '.heap', '.scratch_x', '.scratch_y', '.stack_dummy', '.stack1_dummy'}
+
+# Agrupamento de caminhos em módulos, na ordem
+GRUPOS = [
+    (re.compile(r'/lib/lwip/'), 'lwip'),
+    (re.compile(r'/lib/cyw43-driver/'), 'cyw43-driver'),
+    (re.compile(r'cyw43_resource|43439A0'), 'cyw43-firmware'),
+    (re.compile(r'/src/rp2_common/([^/]+)/'), None),
+    (re.compile(r'/src/common/([^/]+)/'), None),
+    (re.compile(r'/src/rp2040/'), 'rp2040'),
+    (re.compile(r'/common/([^/]+)/'), None),  # código compartilhado do repositório
+]
+
+RE_ARQUIVO = re.compile(r'lib([^/()]+)\.a\(')
+RE_HEX = re.compile(r'^0x[0-9a-fA-F]+$')
+
+
+def modulo_de(caminho):
+    for padrao, nome in GRUPOS:
+        m = padrao.search(caminho)
+        if m:
+            return nome or m.group(1)
+    m = RE_ARQUIVO.search(caminho)
+    if m:
+        return 'lib' + m.group(1)
+    base = os.path.basename(caminho)
+    return re.sub(r'\.(c|cpp|S|s)?\.?(obj|o)$', '', base) or base
+
+
+def ler_mapa(caminho):
+    """Retorna {módulo: [ram, flash]}."""
+    uso = {}
+    secao = None
+    carrega_de_flash = False
+    pendente = None  # nome de seção quebrado em duas linhas
+    dentro = False
+    with open(caminho, encoding='utf-8', errors='replace') as f:
+        for linha in f:
+            if not dentro:
+                dentro = linha.startswith('Linker script and memory map')
+                continue
+            linha = linha.rstrip('\n')
+            if not linha.strip():
+                continue
+
+            # Cabeçalho de seção de saída: começa na coluna 0
+            if linha[0] == '.':
+                partes = linha.split()
+                secao = partes[0]
+                carrega_de_flash = 'load address' in linha
+                continue
+
+            partes = linha.split()
+            if pendente is not None:
+                partes = [pendente] + partes
+                pendente = None
+            elif len(partes) == 1 and linha.startswith(' ') and not linha.startswith('  '):
+                pendente = partes[0]  # ".text.nome_longo" sozinho na linha
+                continue
+
+            if secao is None or len(partes) < 3:
+                continue
+            nome, endereco, tamanho = partes[0], partes[1], partes[2]
+            if not (RE_HEX.match(endereco) and RE_HEX.match(tamanho)):
+                continue
+            if nome.startswith('*') and nome != '*fill*':
+                continue  # padrão do script, não seção de entrada
+            tam = int(tamanho, 16)
+            if tam == 0:
+                continue
+            end = int(endereco, 16)
+
+            if secao in SECOES_FLASH:
+                ram, flash = 0, tam
+            elif secao in SECOES_RAM:
+                ram, flash = tam, tam if carrega_de_flash else 0
+            elif end >= 0x20000000 and end < 0x30000000:
+                ram, flash = tam, tam if carrega_de_flash else 0
+            elif end >= 0x10000000 and end < 0x20000000:
+                ram, flash = 0, tam
+            else:
+                continue  # seções de depuração etc.
+
+            if nome == '*fill*':
+                mod = '(alinhamento)'
+            else:
+                mod = modulo_de(' '.join(partes[3:])) if len(partes) > 3 else '(linker)'
+            total = uso.setdefault(mod, [0, 0])
+            total[0] += ram
+            total[1] += flash
+    if not dentro:
+        raise ValueError(f'{caminho}: seção "Linker script and memory map" não encontrada')
+    return uso
+
+
+def ler_orcamento(caminho):
+    limites = {}
+    with open(caminho, encoding='utf-8') as f:
+        for num, linha in enumerate(f, 1):
+            linha = linha.split('#', 1)[0].split()
+            if not linha:
+                continue
+            if len(linha) != 3:
+                raise ValueError(f'{caminho}:{num}: esperado "<módulo> <ram_max> <flash_max>"')
+            valores = [None if v == '-' else int(v, 0) for v in linha[1:]]
+            limites[linha[0]] = valores
+    return limites
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('mapa')
+    parser.add_argument('--budget', help='arquivo de limites por módulo')
+    parser.add_argument('--top', type=int, default=0, help='mostra só os N maiores módulos em RAM')
+    args = parser.parse_args()
+
+    uso = ler_mapa(args.mapa)
+    limites = ler_orcamento(args.budget) if args.budget else {}
+    total = [sum(v[0] for v in uso.values()), sum(v[1] for v in uso.values())]
+
+    def marca(mod, valores):
+        lim = limites.get(mod, [None, None])
+        estouros = [l is not None and v > l for v, l in zip(valores, lim)]
+        texto = '' if lim == [None, None] else ' '.join('-' if l is None else str(l) for l in lim)
+        return estouros, texto
+
+    modulos = sorted(uso.items(), key=lambda kv: (-kv[1][0], -kv[1][1]))
+    falhou = [mod for mod, valores in modulos + [('TOTAL', total)] if any(marca(mod, valores)[0])]
+    # --top só reduz a tabela; módulos estourados sempre aparecem
+    linhas = modulos[:args.top] if args.top else modulos
+    linhas += [kv for kv in modulos if kv[0] in falhou and kv not in linhas]
+    linhas.append(('TOTAL', total))
+
+    print(f'{"módulo":<28} {"RAM":>9} {"flash":>9}  limites')
+    for mod, valores in linhas:
+        estouros, texto = marca(mod, valores)
+        flag = '  << ESTOURO' if any(estouros) else ''
+        if mod == 'TOTAL':
+            print('-' * 50)
+        print(f'{mod:<28} {valores[0]:>9} {valores[1]:>9}  {texto}{flag}')
+
+    for mod in limites:
+        if mod != 'TOTAL' and mod not in uso:
+            print(f'aviso: módulo "{mod}" do orçamento não aparece no mapa', file=sys.stderr)
+
+    if falhou:
+        print(f'orçamento de memória excedido: {", ".join(falhou)}', file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Relatório do profiler por amostragem (common/profile) simbolizado contra o ELF.
+
+Uso:
+    profile_report.py dump.txt --elf firmware.elf [--top 25] [--baseline antes.txt]
+                      [--linhas] [--clock-mhz 125]
+
+O dump é o texto entre "#PRF-BEGIN" e "#PRF-END", vindo do log da UART (tecla 'P')
+ou de "curl http://<placa>/profile"; linhas de outras origens são ignoradas e, se
+houver vários dumps, vale o último. Cada PC é atribuído à função que o contém
+(tabela de símbolos do ELF via nm). Imprime o perfil plano das N funções mais
+amostradas e o custo estimado da própria amostragem.
+
+Com --baseline, o perfil de antes aparece ao lado e a coluna delta mostra a mudança
+de participação de cada função; é o formato esperado nos números de antes/depois
+das mudanças de desempenho.
+"""
+
+import argparse
+import bisect
+import re
+import subprocess
+import sys
+
+# Ciclos de entrada e saída de exceção no Cortex-M0+ (empilhar/desempilhar o quadro),
+# que o SysTick dentro do ISR não vê
+CICLOS_ENTRADA_SAIDA = 32
+
+RE_INICIO = re.compile(r'#PRF-BEGIN\s+(.*)')
+RE_LINHA = re.compile(r'#PRF\s+([0-9a-fA-F]+)\s+(\d+)')
+
+
+def ler_dump(caminho):
+    """Retorna (cabeçalho {chave: int}, {pc: contagem}) do último dump completo."""
+    cabecalho, pcs, atual = None, None, None
+    with open(caminho, errors='replace') as f:
+        for linha in f:
+            m = RE_INICIO.search(linha)
+            if m:
+                atual = ({}, {})
+                for par in m.group(1).split():
+                    chave, _, valor = par.partition('=')
+                    atual[0][chave] = int(valor)
+                continue
+            if atual is None:
+                continue
+            if '#PRF-END' in linha:
+                cabecalho, pcs = atual
+                atual = None
+                continue
+            m = RE_LINHA.search(linha)
+            if m:
+                pc = int(m.group(1), 16)
+                atual[1][pc] = atual[1].get(pc, 0) + int(m.group(2))
+    if cabecalho is None:
+        sys.exit(f'{caminho}: nenhum dump #PRF-BEGIN ... #PRF-END completo')
+    return cabecalho, pcs
+
+
+class Simbolos:
+    """Funções do ELF ordenadas por endereço."""
+
+    def __init__(self, elf, nm):
+        saida = subprocess.run([nm, '-n', '-S', '--defined-only', elf],
+                               check=True, capture_output=True, text=True).stdout
+        self.inicios, self.fins, self.nomes = [], [], []
+        for linha in saida.splitlines():
+            partes = linha.split()
+            if len(partes) == 4:
+                endereco, tamanho, tipo, nome = partes
+            elif len(partes) == 3:
+                (endereco, tipo, nome), tamanho = partes, None
+            else:
+                continue
+            # Código em flash (t/T/w/W) e funções copiadas para a RAM (.time_critical, em .data)
+            if tipo not in 'tTwWdD':
+                continue
+            inicio = int(endereco, 16)
+            fim = inicio + int(tamanho, 16) if tamanho else None
+            self.inicios.append(inicio & ~1)
+            self.fins.append(fim)
+            self.nomes.append(nome)
+
+    def funcao(self, pc):
+        i = bisect.bisect_right(self.inicios, pc) - 1
+        if i < 0 or (self.fins[i] is not None and pc >= self.fins[i]):
+            return f'?? {pc:#010x}'
+        return self.nomes[i]
+
+
+def agrupar(pcs, simbolos):
+    """Retorna {função: [contagem, pc mais quente, contagem do pc]}."""
+    funcoes = {}
+    for pc, n in pcs.items():
+        f = funcoes.setdefault(simbolos.funcao(pc), [0, pc, 0])
+        f[0] += n
+        if n > f[2]:
+            f[1], f[2] = pc, n
+    return funcoes
+
+
+def linhas_fonte(elf, addr2line, pcs):
+    if not pcs:
+        return {}
+    saida = subprocess.run([addr2line, '-e', elf] + [f'{pc:#x}' for pc in pcs],
+                           check=True, capture_output=True, text=True).stdout.splitlines()
+    return {pc: linha.rsplit('/', 1)[-1] for pc, linha in zip(pcs, saida)}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument('dump')
+    ap.add_argument('--elf', required=True)
+    ap.add_argument('--top', type=int, default=25, help='funções no relatório (padrão 25)')
+    ap.add_argument('--baseline', help='dump de antes da mudança, para comparação')
+    ap.add_argument('--linhas', action='store_true', help='arquivo:linha do PC mais quente de cada função')
+    ap.add_argument('--clock-mhz', type=float, default=125.0)
+    ap.add_argument('--nm', default='arm-none-eabi-nm')
+    ap.add_argument('--addr2line', default='arm-none-eabi-addr2line')
+    args = ap.parse_args()
+
+    simbolos = Simbolos(args.elf, args.nm)
+    cab, pcs = ler_dump(args.dump)
+    funcoes = agrupar(pcs, simbolos)
+    total = sum(pcs.values()) or 1
+
+    antes, total_antes = {}, 1
+    if args.baseline:
+        _, pcs_antes = ler_dump(args.baseline)
+        antes = {nome: v[0] for nome, v in agrupar(pcs_antes, simbolos).items()}
+        total_antes = sum(pcs_antes.values()) or 1
+
+    hz = cab.get('hz', 0)
+    ciclos = cab.get('ciclos_med', 0) + CICLOS_ENTRADA_SAIDA
+    custo = 100.0 * ciclos * hz / (args.clock_mhz * 1e6)
+    print(f'amostras: {cab.get("amostras", total)} a {hz} Hz (~{total / hz if hz else 0:.1f} s), '
+          f'perdidas: {cab.get("perdidas", 0)}, PCs distintos: {len(pcs)}')
+    print(f'custo da amostragem: ~{ciclos} ciclos por amostra '
+          f'(máx {cab.get("ciclos_max", 0) + CICLOS_ENTRADA_SAIDA}) = {custo:.3f}% da CPU')
+    print()
+
+    ordem = sorted(funcoes.items(), key=lambda kv: -kv[1][0])[:args.top]
+    fontes = linhas_fonte(args.elf, args.addr2line, [v[1] for _, v in ordem]) if args.linhas else {}
+
+    cab_base = f' {"antes%":>7} {"delta":>7}' if args.baseline else ''
+    print(f'{"amostras":>9} {"%":>6} {"acum%":>6}{cab_base}  função')
+    acum = 0.0
+    for nome, (n, pc_quente, _) in ordem:
+        pct = 100.0 * n / total
+        acum += pct
+        base = ''
+        if args.baseline:
+            pct_antes = 100.0 * antes.get(nome, 0) / total_antes
+            base = f' {pct_antes:7.2f} {pct - pct_antes:+7.2f}'
+        fonte = f'  ({fontes[pc_quente]})' if pc_quente in fontes else ''
+        print(f'{n:9d} {pct:6.2f} {acum:6.2f}{base}  {nome}{fonte}')
+    resto = total - sum(v[0] for _, v in ordem)
+    if resto:
+        print(f'{resto:9d} {100.0 * resto / total:6.2f} {"":>6}{" " * len(cab_base)}  (outras {len(funcoes) - len(ordem)} funções)')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())